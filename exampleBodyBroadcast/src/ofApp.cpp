@@ -0,0 +1,152 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	kinect.open();
+	kinect.initBodySource();
+	useDemoBody = !kinect.isOpen();
+	receiving = true;
+
+	//a short keyframe interval makes the keyframes easy to spot in the counts
+	broadcaster.open("127.0.0.1", ofxKFW2::Network::DefaultBodyPort);
+	broadcaster.setKeyframeInterval(10);
+	receiver.open(ofxKFW2::Network::DefaultBodyPort);
+
+	demoBodies.resize(1);
+	demoBodies[0].bodyId = 0;
+	demoBodies[0].trackingId = 1;
+	demoBodies[0].tracked = true;
+	demoBodies[0].leftHandState = HandState_Open;
+	demoBodies[0].rightHandState = HandState_Closed;
+
+	camera.setDistance(3.0f);
+	camera.setNearClip(0.01f);
+	camera.setTarget(ofVec3f(0, 0, 2));
+
+	ofSetWindowShape(1024, 768);
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	kinect.update();
+	if (useDemoBody) {
+		sendDemoBody();
+	}
+	else if (kinect.getBodySource()->isFrameNew()) {
+		broadcaster.send(*kinect.getBodySource());
+	}
+
+	//while paused the datagrams queue up in the socket, and arrive late when we resume
+	if (receiving) {
+		receiver.update();
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::sendDemoBody(){
+	//a standing skeleton which waves its right arm
+	static const float pose[JointType_Count][3] = {
+		{ 0.0f, -0.1f, 2.0f }, { 0.0f, 0.2f, 2.0f }, { 0.0f, 0.45f, 2.0f }, { 0.0f, 0.6f, 2.0f },
+		{ -0.2f, 0.4f, 2.0f }, { -0.3f, 0.15f, 2.0f }, { -0.35f, -0.1f, 2.0f }, { -0.36f, -0.18f, 2.0f },
+		{ 0.2f, 0.4f, 2.0f }, { 0.3f, 0.15f, 2.0f }, { 0.35f, -0.1f, 2.0f }, { 0.36f, -0.18f, 2.0f },
+		{ -0.1f, -0.15f, 2.0f }, { -0.12f, -0.55f, 2.0f }, { -0.12f, -0.95f, 2.0f }, { -0.12f, -1.0f, 1.9f },
+		{ 0.1f, -0.15f, 2.0f }, { 0.12f, -0.55f, 2.0f }, { 0.12f, -0.95f, 2.0f }, { 0.12f, -1.0f, 1.9f },
+		{ 0.0f, 0.4f, 2.0f }, { -0.37f, -0.24f, 2.0f }, { -0.33f, -0.2f, 1.95f }, { 0.37f, -0.24f, 2.0f }, { 0.33f, -0.2f, 1.95f }
+	};
+
+	const float angle = sin(ofGetElapsedTimef() * 3.0f) * 0.8f + 1.6f;
+	_Joint joints[JointType_Count];
+	_JointOrientation jointOrientations[JointType_Count];
+	DepthSpacePoint positionsInDepthMap[JointType_Count];
+	for (int i = 0; i < JointType_Count; i++) {
+		ofVec3f position(pose[i][0], pose[i][1], pose[i][2]);
+		const bool rightArm = (i >= JointType_ElbowRight && i <= JointType_HandRight) || i >= JointType_HandTipRight;
+		if (rightArm) {
+			//swing about the right shoulder
+			position = (position - ofVec3f(pose[JointType_ShoulderRight][0], pose[JointType_ShoulderRight][1], pose[JointType_ShoulderRight][2]))
+				.getRotatedRad(angle, ofVec3f(0, 0, 1))
+				+ ofVec3f(pose[JointType_ShoulderRight][0], pose[JointType_ShoulderRight][1], pose[JointType_ShoulderRight][2]);
+		}
+		joints[i].JointType = (JointType) i;
+		joints[i].TrackingState = TrackingState_Tracked;
+		joints[i].Position.X = position.x;
+		joints[i].Position.Y = position.y;
+		joints[i].Position.Z = position.z;
+		jointOrientations[i].JointType = (JointType) i;
+		jointOrientations[i].Orientation.x = 0;
+		jointOrientations[i].Orientation.y = 0;
+		jointOrientations[i].Orientation.z = 0;
+		jointOrientations[i].Orientation.w = 1;
+		positionsInDepthMap[i].X = 0;
+		positionsInDepthMap[i].Y = 0;
+	}
+	demoBodies[0].setJoints(joints, jointOrientations, positionsInDepthMap);
+
+	//the Kinect ticks in 100ns units
+	broadcaster.send(demoBodies, (INT64) (ofGetElapsedTimeMicros() * 10));
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	ofBackground(40);
+
+	//the received bodies, mirrored so that they face us
+	camera.begin();
+	ofPushMatrix();
+	ofScale(-1, 1, -1);
+	ofSetColor(255);
+	ofSetLineWidth(3);
+	for (auto & body : receiver.getBodies()) {
+		body.drawWorld();
+	}
+	ofPopMatrix();
+	camera.end();
+
+	int receivedBodies = 0;
+	for (auto & body : receiver.getBodies()) {
+		if (body.tracked) {
+			receivedBodies++;
+		}
+	}
+
+	const auto sentPackets = broadcaster.getSentPacketCount();
+	const auto sentKeyframes = broadcaster.getSentKeyframeCount();
+	const auto receivedKeyframes = receiver.getReceivedKeyframeCount();
+
+	stringstream status;
+	status << "fps : " << ofGetFrameRate() << endl
+		<< "source : " << (useDemoBody ? "generated body" : "sensor") << endl
+		<< "keyframe interval : " << broadcaster.getKeyframeInterval() << endl
+		<< endl
+		<< "sent packets : " << sentPackets << " (" << sentKeyframes << " keyframes, " << sentPackets - sentKeyframes << " deltas)" << endl
+		<< "sent bytes : " << broadcaster.getSentByteCount() << " (" << (sentPackets > 0 ? broadcaster.getSentByteCount() / sentPackets : 0) << " per packet)" << endl
+		<< endl
+		<< "receiving : " << (receiving ? "yes" : "paused") << endl
+		<< "received packets : " << receiver.getReceivedPacketCount() << " (" << receivedKeyframes << " keyframes)" << endl
+		<< "discarded packets : " << receiver.getDiscardedPacketCount() << endl
+		<< "received bodies : " << receivedBodies << endl
+		<< endl
+		<< "[+/-] keyframe interval" << endl
+		<< "[d] toggle generated body" << endl
+		<< "[p] pause receiving";
+	ofDrawBitmapStringHighlight(status.str(), 10, 20);
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	switch (key) {
+	case '+':
+	case '=':
+		broadcaster.setKeyframeInterval(broadcaster.getKeyframeInterval() + 1);
+		break;
+	case '-':
+		broadcaster.setKeyframeInterval(broadcaster.getKeyframeInterval() - 1);
+		break;
+	case 'd':
+		useDemoBody = !useDemoBody;
+		break;
+	case 'p':
+		receiving = !receiving;
+		break;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxKinectForWindows2.h"
+
+// Broadcasts bodies with a Network::BodyBroadcaster and reads them back with a Network::BodyReceiver over localhost.
+// With no sensor attached a generated body is sent instead, so the keyframe / delta traffic can be watched anywhere.
+// To split it across machines, run the sender with the receiver's address (or the default broadcast address).
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void update();
+		void draw();
+
+		void keyPressed(int key);
+
+		void sendDemoBody();
+
+		ofxKFW2::Device kinect;
+		ofxKFW2::Network::BodyBroadcaster broadcaster;
+		ofxKFW2::Network::BodyReceiver receiver;
+
+		bool useDemoBody;
+		bool receiving;
+		vector<ofxKFW2::Data::Body> demoBodies;
+
+		ofEasyCam camera;
+};
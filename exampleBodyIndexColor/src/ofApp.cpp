@@ -1,7 +1,8 @@
 // This example shows how to work with the BodyIndex image in order to create
 // a green screen effect. Note that this isn't super fast, but is helpful
 // in understanding how the different image types & coordinate spaces work
-// together. If you need performance, you will probably want to do this with shaders!
+// together. If you need performance, use ofxKFW2::Processing::Greenscreen (full color
+// resolution, multithreaded) or do this with shaders!
 
 #include "ofApp.h"
 
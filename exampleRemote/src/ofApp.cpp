@@ -0,0 +1,71 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	kinect.open();
+	kinect.initDepthSource();
+	kinect.initColorSource();
+	kinect.initBodyIndexSource();
+	kinect.initBodySource();
+
+	server.setColorDownscale(4);
+	server.open(ofxKFW2::Network::DefaultPort);
+
+	//the remote device looks like a local one, but its sources are fed by the server
+	remote.openRemote("127.0.0.1", ofxKFW2::Network::DefaultPort);
+	remote.initDepthSource();
+	remote.initColorSource();
+	remote.initBodyIndexSource();
+	remote.initBodySource();
+
+	ofSetWindowShape(512 * 2, 424 * 2);
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	kinect.update();
+	server.publish(kinect);
+
+	remote.update();
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	//local on the left, received on the right
+	kinect.getDepthSource()->draw(0, 0, 512, 424);
+	kinect.getBodyIndexSource()->draw(0, 424, 512, 424);
+	kinect.getBodySource()->drawProjected(0, 424, 512, 424, ofxKFW2::ProjectionCoordinates::DepthCamera);
+
+	remote.getDepthSource()->draw(512, 0, 512, 424);
+	remote.getColorSource()->draw(512, 424, 512, 288);
+
+	int remoteBodies = 0;
+	for (auto & body : remote.getBodySource()->getBodies()) {
+		if (body.tracked) {
+			remoteBodies++;
+		}
+	}
+
+	stringstream status;
+	status << "fps : " << ofGetFrameRate() << endl
+		<< "clients : " << server.getClientCount() << endl
+		<< "dropped messages : " << server.getDroppedMessageCount() << endl
+		<< "remote connected : " << (remote.isOpen() ? "yes" : "no") << endl
+		<< "local depth time : " << kinect.getDepthSource()->getRelativeTime() << endl
+		<< "remote depth time : " << remote.getDepthSource()->getRelativeTime() << endl
+		<< "remote bodies : " << remoteBodies << endl
+		<< "remote coordinate mapper : " << (remote.getDepthSource()->getCoordinateMapper() ? "yes" : "no (projections need the local sensor)") << endl
+		<< "[r] reconnect";
+	ofDrawBitmapStringHighlight(status.str(), 10, 20);
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	if (key == 'r') {
+		remote.openRemote("127.0.0.1", ofxKFW2::Network::DefaultPort);
+		remote.initDepthSource();
+		remote.initColorSource();
+		remote.initBodyIndexSource();
+		remote.initBodySource();
+	}
+}
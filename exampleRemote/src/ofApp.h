@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxKinectForWindows2.h"
+
+// Serves the local sensor with a Network::Server and reads it back over localhost through Device::openRemote,
+// to check a sender / receiver setup on one machine before splitting it across two.
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void update();
+		void draw();
+
+		void keyPressed(int key);
+
+		ofxKFW2::Device kinect;
+		ofxKFW2::Network::Server server;
+		ofxKFW2::Device remote;
+};
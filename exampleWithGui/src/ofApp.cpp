@@ -43,12 +43,10 @@ void ofApp::setup(){
 				};
 			}
 
-			//if it's the depth panel, set some scaling
+			//if it's the depth panel, show it in false colour
 			auto depthSource = dynamic_pointer_cast<ofxKFW2::Source::Depth>(source);
 			if (depthSource) {
-				auto style = make_shared<ofxCvGui::Panels::Texture::Style>();
-				style->rangeMaximum = 0.25f;
-				panel->setStyle(style);
+				depthSource->getColorizer().setPalette(ofxKFW2::Processing::DepthColorizer::Turbo);
 			}
 
 			//if it's the body index panel, let's draw the joints on top
@@ -1,5 +1,15 @@
 #pragma once
 
 #include "ofxKinectForWindows2/Device.h"
+#include "ofxKinectForWindows2/Network/BodyBroadcaster.h"
+#include "ofxKinectForWindows2/Network/BodyReceiver.h"
+#include "ofxKinectForWindows2/Network/Server.h"
+#include "ofxKinectForWindows2/Processing/BodyContours.h"
+#include "ofxKinectForWindows2/Processing/BodyPointClouds.h"
+#include "ofxKinectForWindows2/Processing/Graph.h"
+#include "ofxKinectForWindows2/Processing/Greenscreen.h"
+#include "ofxKinectForWindows2/Processing/MarkerDetector.h"
+#include "ofxKinectForWindows2/Processing/PoseClassifier.h"
+#include "ofxKinectForWindows2/SharedMemory/Reader.h"
 
 #define ofxKFW2 ofxKinectForWindows2
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include "BitMask.h"
+#include "ofMain.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define OFXKFW2_BITMASK_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+		//----------
+		static inline int popCount(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			return (int) __popcnt64(word);
+#elif defined(__GNUC__)
+			return __builtin_popcountll(word);
+#else
+			word = word - ((word >> 1) & 0x5555555555555555ULL);
+			word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+			word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return (int) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+		}
+
+		//----------
+		BitMask::BitMask() {
+			this->width = 0;
+			this->height = 0;
+			this->wordsPerRow = 0;
+		}
+
+		//----------
+		BitMask::BitMask(int width, int height) {
+			this->allocate(width, height);
+		}
+
+		//----------
+		void BitMask::allocate(int width, int height) {
+			this->width = width;
+			this->height = height;
+			this->wordsPerRow = (width + 63) / 64;
+			this->words.assign(this->wordsPerRow * height, 0);
+		}
+
+		//----------
+		bool BitMask::isAllocated() const {
+			return !this->words.empty();
+		}
+
+		//----------
+		int BitMask::getWidth() const {
+			return this->width;
+		}
+
+		//----------
+		int BitMask::getHeight() const {
+			return this->height;
+		}
+
+		//----------
+		int BitMask::getWordsPerRow() const {
+			return this->wordsPerRow;
+		}
+
+		//----------
+		uint64_t * BitMask::getData() {
+			return this->words.data();
+		}
+
+		//----------
+		const uint64_t * BitMask::getData() const {
+			return this->words.data();
+		}
+
+		//----------
+		bool BitMask::get(int x, int y) const {
+			return (this->words[y * this->wordsPerRow + x / 64] >> (x % 64)) & 1;
+		}
+
+		//----------
+		void BitMask::set(int x, int y, bool value) {
+			auto & word = this->words[y * this->wordsPerRow + x / 64];
+			const uint64_t bit = (uint64_t) 1 << (x % 64);
+			word = value ? word | bit : word & ~bit;
+		}
+
+		//----------
+		void BitMask::clear() {
+			std::fill(this->words.begin(), this->words.end(), 0);
+		}
+
+		//----------
+		void BitMask::fill() {
+			std::fill(this->words.begin(), this->words.end(), ~(uint64_t) 0);
+			this->clearPadding();
+		}
+
+		//----------
+		void BitMask::setFromBodyIndex(const ofPixels & bodyIndex, int body) {
+			const int width = (int) bodyIndex.getWidth();
+			const int height = (int) bodyIndex.getHeight();
+			if (this->width != width || this->height != height) {
+				this->allocate(width, height);
+			}
+
+			for (int y = 0; y < height; y++) {
+				const unsigned char * row = bodyIndex.getData() + y * width;
+				uint64_t * output = this->words.data() + y * this->wordsPerRow;
+				for (int w = 0; w < this->wordsPerRow; w++) {
+					const int begin = w * 64;
+					const int end = std::min(begin + 64, width);
+					uint64_t word = 0;
+					int x = begin;
+#ifdef OFXKFW2_BITMASK_SSE2
+					if (body >= 0) {
+						const __m128i value = _mm_set1_epi8((char) body);
+						for (; x + 16 <= end; x += 16) {
+							__m128i pixels = _mm_loadu_si128((const __m128i *) (row + x));
+							word |= (uint64_t) (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(pixels, value)) << (x - begin);
+						}
+					}
+					else {
+						const __m128i last = _mm_set1_epi8((char) (BODY_COUNT - 1));
+						for (; x + 16 <= end; x += 16) {
+							__m128i pixels = _mm_loadu_si128((const __m128i *) (row + x));
+							__m128i inside = _mm_cmpeq_epi8(_mm_min_epu8(pixels, last), pixels);
+							word |= (uint64_t) (unsigned int) _mm_movemask_epi8(inside) << (x - begin);
+						}
+					}
+#endif
+					for (; x < end; x++) {
+						const bool inside = body >= 0 ? row[x] == body : row[x] < BODY_COUNT;
+						word |= (uint64_t) inside << (x - begin);
+					}
+					output[w] = word;
+				}
+			}
+		}
+
+		//----------
+		void BitMask::fromBodyIndex(const ofPixels & bodyIndex, BitMask * bodies, BitMask & anyBody) {
+			const int width = (int) bodyIndex.getWidth();
+			const int height = (int) bodyIndex.getHeight();
+			for (int b = 0; b < BODY_COUNT; b++) {
+				if (bodies[b].width != width || bodies[b].height != height) {
+					bodies[b].allocate(width, height);
+				}
+			}
+			if (anyBody.width != width || anyBody.height != height) {
+				anyBody.allocate(width, height);
+			}
+			const int wordsPerRow = anyBody.wordsPerRow;
+
+			for (int y = 0; y < height; y++) {
+				const unsigned char * row = bodyIndex.getData() + y * width;
+				for (int w = 0; w < wordsPerRow; w++) {
+					const int begin = w * 64;
+					const int end = std::min(begin + 64, width);
+					uint64_t bodyWords[BODY_COUNT] = { 0 };
+					int x = begin;
+#ifdef OFXKFW2_BITMASK_SSE2
+					const __m128i background = _mm_set1_epi8((char) 0xFF);
+					for (; x + 16 <= end; x += 16) {
+						__m128i pixels = _mm_loadu_si128((const __m128i *) (row + x));
+						if (_mm_movemask_epi8(_mm_cmpeq_epi8(pixels, background)) == 0xFFFF) {
+							continue;
+						}
+						for (int b = 0; b < BODY_COUNT; b++) {
+							__m128i inside = _mm_cmpeq_epi8(pixels, _mm_set1_epi8((char) b));
+							bodyWords[b] |= (uint64_t) (unsigned int) _mm_movemask_epi8(inside) << (x - begin);
+						}
+					}
+#endif
+					for (; x < end; x++) {
+						if (row[x] < BODY_COUNT) {
+							bodyWords[row[x]] |= (uint64_t) 1 << (x - begin);
+						}
+					}
+
+					uint64_t anyWord = 0;
+					for (int b = 0; b < BODY_COUNT; b++) {
+						bodies[b].words[y * wordsPerRow + w] = bodyWords[b];
+						anyWord |= bodyWords[b];
+					}
+					anyBody.words[y * wordsPerRow + w] = anyWord;
+				}
+			}
+		}
+
+		//----------
+		BitMask & BitMask::operator&=(const BitMask & other) {
+			if (this->matches(other)) {
+				for (size_t i = 0; i < this->words.size(); i++) {
+					this->words[i] &= other.words[i];
+				}
+			}
+			return *this;
+		}
+
+		//----------
+		BitMask & BitMask::operator|=(const BitMask & other) {
+			if (this->matches(other)) {
+				for (size_t i = 0; i < this->words.size(); i++) {
+					this->words[i] |= other.words[i];
+				}
+			}
+			return *this;
+		}
+
+		//----------
+		BitMask & BitMask::operator^=(const BitMask & other) {
+			if (this->matches(other)) {
+				for (size_t i = 0; i < this->words.size(); i++) {
+					this->words[i] ^= other.words[i];
+				}
+			}
+			return *this;
+		}
+
+		//----------
+		void BitMask::invert() {
+			for (auto & word : this->words) {
+				word = ~word;
+			}
+			this->clearPadding();
+		}
+
+		//----------
+		void BitMask::dilate(int iterations) {
+			const int stride = this->wordsPerRow;
+			for (int iteration = 0; iteration < iterations; iteration++) {
+				//horizontal into scratch, carrying bits across word boundaries
+				this->scratch.resize(this->words.size());
+				for (int y = 0; y < this->height; y++) {
+					const uint64_t * row = this->words.data() + y * stride;
+					uint64_t * output = this->scratch.data() + y * stride;
+					for (int w = 0; w < stride; w++) {
+						const uint64_t previous = w > 0 ? row[w - 1] : 0;
+						const uint64_t next = w + 1 < stride ? row[w + 1] : 0;
+						output[w] = row[w] | (row[w] << 1) | (previous >> 63) | (row[w] >> 1) | (next << 63);
+					}
+				}
+
+				//vertical back into words
+				for (int y = 0; y < this->height; y++) {
+					const uint64_t * above = y > 0 ? this->scratch.data() + (y - 1) * stride : nullptr;
+					const uint64_t * row = this->scratch.data() + y * stride;
+					const uint64_t * below = y + 1 < this->height ? this->scratch.data() + (y + 1) * stride : nullptr;
+					uint64_t * output = this->words.data() + y * stride;
+					for (int w = 0; w < stride; w++) {
+						output[w] = row[w] | (above ? above[w] : 0) | (below ? below[w] : 0);
+					}
+				}
+				this->clearPadding();
+			}
+		}
+
+		//----------
+		void BitMask::erode(int iterations) {
+			const int stride = this->wordsPerRow;
+			for (int iteration = 0; iteration < iterations; iteration++) {
+				this->scratch.resize(this->words.size());
+				for (int y = 0; y < this->height; y++) {
+					const uint64_t * row = this->words.data() + y * stride;
+					uint64_t * output = this->scratch.data() + y * stride;
+					for (int w = 0; w < stride; w++) {
+						const uint64_t previous = w > 0 ? row[w - 1] : 0;
+						const uint64_t next = w + 1 < stride ? row[w + 1] : 0;
+						output[w] = row[w] & ((row[w] << 1) | (previous >> 63)) & ((row[w] >> 1) | (next << 63));
+					}
+				}
+				//padding bits are 0, so the last valid pixel of a row is eroded by its (unset) right neighbour
+
+				for (int y = 0; y < this->height; y++) {
+					uint64_t * output = this->words.data() + y * stride;
+					if (y == 0 || y + 1 == this->height) {
+						std::fill(output, output + stride, 0);
+						continue;
+					}
+					const uint64_t * above = this->scratch.data() + (y - 1) * stride;
+					const uint64_t * row = this->scratch.data() + y * stride;
+					const uint64_t * below = this->scratch.data() + (y + 1) * stride;
+					for (int w = 0; w < stride; w++) {
+						output[w] = row[w] & above[w] & below[w];
+					}
+				}
+			}
+		}
+
+		//----------
+		int BitMask::count() const {
+			int count = 0;
+			for (auto word : this->words) {
+				count += popCount(word);
+			}
+			return count;
+		}
+
+		//----------
+		void BitMask::apply(const ofShortPixels & input, ofShortPixels & output, unsigned short background) const {
+			if (input.getWidth() != this->width || input.getHeight() != this->height || input.getNumChannels() != 1) {
+				OFXKINECTFORWINDOWS2_ERROR << "BitMask::apply expects single channel pixels of the mask's size";
+				return;
+			}
+			if (output.getWidth() != this->width || output.getHeight() != this->height || output.getNumChannels() != 1) {
+				output.allocate(this->width, this->height, OF_PIXELS_GRAY);
+			}
+
+			for (int y = 0; y < this->height; y++) {
+				const unsigned short * inputRow = input.getData() + y * this->width;
+				unsigned short * outputRow = output.getData() + y * this->width;
+				const uint64_t * row = this->words.data() + y * this->wordsPerRow;
+				for (int w = 0; w < this->wordsPerRow; w++) {
+					const int begin = w * 64;
+					const int end = std::min(begin + 64, this->width);
+					const uint64_t word = row[w];
+					if (word == 0) {
+						std::fill(outputRow + begin, outputRow + end, background);
+					}
+					else if (end - begin == 64 && word == ~(uint64_t) 0) {
+						memcpy(outputRow + begin, inputRow + begin, 64 * sizeof(unsigned short));
+					}
+					else {
+						for (int x = begin; x < end; x++) {
+							outputRow[x] = (word >> (x - begin)) & 1 ? inputRow[x] : background;
+						}
+					}
+				}
+			}
+		}
+
+		//----------
+		bool BitMask::matches(const BitMask & other) const {
+			if (this->width != other.width || this->height != other.height) {
+				OFXKINECTFORWINDOWS2_ERROR << "BitMask sizes don't match";
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		void BitMask::clearPadding() {
+			const int usedBits = this->width % 64;
+			if (usedBits == 0) {
+				return;
+			}
+			const uint64_t lastWordMask = ((uint64_t) 1 << usedBits) - 1;
+			for (int y = 0; y < this->height; y++) {
+				this->words[(y + 1) * this->wordsPerRow - 1] &= lastWordMask;
+			}
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include "ofPixels.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+		// 1 bit per pixel mask, e.g. one body of the BodyIndex frame.
+		// Rows are padded to whole 64 bit words (padding bits are always 0), so a 512x424 mask is 27KB
+		// and mask operations work 64 pixels at a time.
+		class BitMask {
+		public:
+			BitMask();
+			BitMask(int width, int height);
+
+			// Allocates an empty mask
+			void allocate(int width, int height);
+			bool isAllocated() const;
+			int getWidth() const;
+			int getHeight() const;
+			int getWordsPerRow() const;
+
+			uint64_t * getData();
+			const uint64_t * getData() const;
+
+			bool get(int x, int y) const;
+			void set(int x, int y, bool);
+			void clear();
+			void fill();
+
+			// Pixels of the BodyIndex frame belonging to this body, or to any body if body is -1
+			void setFromBodyIndex(const ofPixels & bodyIndex, int body = -1);
+			// All BODY_COUNT body masks and the any body mask in one pass over the BodyIndex frame
+			static void fromBodyIndex(const ofPixels & bodyIndex, BitMask * bodies, BitMask & anyBody);
+
+			BitMask & operator&=(const BitMask &);
+			BitMask & operator|=(const BitMask &);
+			BitMask & operator^=(const BitMask &);
+			void invert();
+
+			// 3x3 morphology, repeated. Pixels outside the mask count as unset.
+			void dilate(int iterations = 1);
+			void erode(int iterations = 1);
+
+			// Number of set pixels
+			int count() const;
+
+			// output = mask ? input : background, e.g. to cut bodies out of the depth or infrared frames
+			void apply(const ofShortPixels & input, ofShortPixels & output, unsigned short background = 0) const;
+		protected:
+			bool matches(const BitMask &) const;
+			void clearPadding();
+
+			int width;
+			int height;
+			int wordsPerRow;
+			vector<uint64_t> words;
+			vector<uint64_t> scratch;
+		};
+	}
+}
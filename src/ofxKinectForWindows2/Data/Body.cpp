@@ -12,6 +12,59 @@ namespace ofxKinectForWindows2 {
 			this->tracked = false;
 			this->leftHandState = HandState::HandState_Unknown;
 			this->rightHandState = HandState::HandState_Unknown;
+			for (auto & trackingState : this->jointArrays.trackingStates) {
+				trackingState = TrackingState_NotTracked;
+			}
+		}
+
+		//----------
+		void Body::setJoints(const _Joint * joints, const _JointOrientation * jointOrientations, const DepthSpacePoint * positionsInDepthMap) {
+			for (int i = 0; i < JointType_Count; i++) {
+				auto type = joints[i].JointType;
+				const auto & position = joints[i].Position;
+				const auto & orientation = jointOrientations[i].Orientation;
+
+				this->joints.set(type, Joint(joints[i], jointOrientations[i], ofVec2f(positionsInDepthMap[i].X, positionsInDepthMap[i].Y)));
+
+				this->jointArrays.positions[type].set(position.X, position.Y, position.Z);
+				this->jointArrays.orientations[type].set(orientation.x, orientation.y, orientation.z, orientation.w);
+				this->jointArrays.trackingStates[type] = joints[i].TrackingState;
+			}
+		}
+
+		//----------
+		void Body::updateJointArrays() {
+			for (int i = 0; i < JointType_Count; i++) {
+				auto type = (JointType) i;
+				if (this->joints.has(type)) {
+					const auto & joint = this->joints.get(type);
+					this->jointArrays.positions[i] = joint.getPositionInWorld();
+					this->jointArrays.orientations[i] = joint.getOrientation();
+					this->jointArrays.trackingStates[i] = joint.getTrackingState();
+				}
+				else {
+					this->jointArrays.trackingStates[i] = TrackingState_NotTracked;
+				}
+			}
+		}
+
+		//----------
+		void Body::applyJointArrays() {
+			for (int i = 0; i < JointType_Count; i++) {
+				auto type = (JointType) i;
+				if (this->jointArrays.trackingStates[i] == TrackingState_NotTracked && !this->joints.has(type)) {
+					continue;
+				}
+				auto & joint = this->joints[type];
+				joint.setPositionInWorld(this->jointArrays.positions[i]);
+				joint.setOrientation(this->jointArrays.orientations[i]);
+				joint.setTrackingState(this->jointArrays.trackingStates[i]);
+			}
+		}
+
+		//----------
+		const Joint & Body::getJoint(JointType type) const {
+			return this->joints.get(type);
 		}
 
 		//----------
@@ -19,17 +72,14 @@ namespace ofxKinectForWindows2 {
 			if (!this->tracked) {
 				return;
 			}
+			//joints rather than jointArrays, so that bodies edited or built through the map API draw as they are
 			const auto & boneAtlas = this->getBonesAtlas();
+			auto isTracked = [this](JointType type) {
+				return this->joints.has(type) && this->joints.get(type).getTrackingState() != TrackingState::TrackingState_NotTracked;
+			};
 			for(auto & bone : boneAtlas) {
-				try {
-					const auto & firstJoint = this->joints.at(bone.first);
-					const auto & secondJoint = this->joints.at(bone.second);
-					if (firstJoint.getTrackingState() != TrackingState::TrackingState_NotTracked && secondJoint.getTrackingState() != TrackingState::TrackingState_NotTracked) {
-						ofDrawLine(firstJoint.getPosition(), secondJoint.getPosition());
-					}
-				}
-				catch (...)	{
-
+				if (isTracked(bone.first) && isTracked(bone.second)) {
+					ofDrawLine(this->joints.get(bone.first).getPositionInWorld(), this->joints.get(bone.second).getPositionInWorld());
 				}
 			}
 		}
@@ -37,6 +87,9 @@ namespace ofxKinectForWindows2 {
 		//----------
 		void Body::clear() {
 			joints.clear();
+			for (auto & trackingState : jointArrays.trackingStates) {
+				trackingState = TrackingState_NotTracked;
+			}
 			leftHandState = HandState_Unknown;
 			rightHandState = HandState_Unknown;
 			tracked = false;
@@ -48,6 +101,7 @@ namespace ofxKinectForWindows2 {
 			for (auto & joint : copy.joints) {
 				joint.second = joint.second * transform;
 			}
+			copy.updateJointArrays();
 			return copy;
 		}
 
@@ -8,15 +8,37 @@ namespace ofxKinectForWindows2 {
 	namespace Data {
 		class Body {
 		public:
+			// Structure of arrays copy of the joints, indexed by JointType.
+			// Contiguous per attribute so that loops over a whole skeleton can vectorize.
+			// joints remains the reference (drawing reads it), this copy is only as fresh as its last sync.
+			struct JointArrays {
+				ofVec3f positions[JointType_Count];
+				ofQuaternion orientations[JointType_Count];
+				TrackingState trackingStates[JointType_Count];
+			};
+
 			Body();
 			uint8_t bodyId;
 			uint64_t trackingId;
 			bool tracked;
 			HandState leftHandState;
 			HandState rightHandState;
-			std::map<JointType, Joint> joints;
+			JointMap joints;
+			JointArrays jointArrays;
 			std::map<Activity, DetectionResult> activity;
 
+			// Set all JointType_Count joints at once, updating both joints and jointArrays
+			void setJoints(const _Joint * joints, const _JointOrientation * jointOrientations, const DepthSpacePoint * positionsInDepthMap);
+
+			// Call this if you have edited joints directly, to bring jointArrays back in sync
+			void updateJointArrays();
+
+			// Call this if you have edited jointArrays directly, to bring joints back in sync
+			// (positionInDepthMap of each joint is left unchanged)
+			void applyJointArrays();
+
+			const Joint & getJoint(JointType) const;
+
 			void drawWorld() const;
 			void clear();
 
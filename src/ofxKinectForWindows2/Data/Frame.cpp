@@ -0,0 +1,87 @@
+#include "Frame.h"
+
+#include <atomic>
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+#pragma mark Frame
+		//----------
+		template<typename PixelType>
+		Frame<PixelType>::Frame() {
+			this->relativeTime = 0;
+			this->frameIndex = 0;
+			this->horizontalFieldOfView = 0.0f;
+			this->verticalFieldOfView = 0.0f;
+		}
+
+#pragma mark FramePool
+		//----------
+		template<typename PixelType>
+		FramePool<PixelType>::FramePool(size_t capacity) {
+			this->capacity = capacity;
+			this->next = 0;
+			this->allocationCount = 0;
+		}
+
+		//----------
+		template<typename PixelType>
+		std::shared_ptr<Frame<PixelType>> FramePool<PixelType>::acquire() {
+			//a frame only referenced by the pool has been dropped by all its readers.
+			//start after the last frame handed out, which is most likely still held by the source
+			const auto count = this->frames.size();
+			for (size_t i = 0; i < count; i++) {
+				auto & frame = this->frames[(this->next + i) % count];
+				if (frame.use_count() == 1) {
+					//pairs with the release of the last reader's reference, so its reads are done before we write
+					std::atomic_thread_fence(std::memory_order_acquire);
+					this->next = (this->next + i + 1) % count;
+					return frame;
+				}
+			}
+
+			auto frame = std::make_shared<Frame<PixelType>>();
+			this->allocationCount++;
+			if (count < this->capacity) {
+				this->frames.push_back(frame);
+				this->next = 0;
+			}
+			return frame;
+		}
+
+		//----------
+		template<typename PixelType>
+		void FramePool<PixelType>::setCapacity(size_t capacity) {
+			this->capacity = capacity;
+			if (this->frames.size() > capacity) {
+				this->frames.resize(capacity);
+				this->next = 0;
+			}
+		}
+
+		//----------
+		template<typename PixelType>
+		size_t FramePool<PixelType>::getCapacity() const {
+			return this->capacity;
+		}
+
+		//----------
+		template<typename PixelType>
+		size_t FramePool<PixelType>::getAllocationCount() const {
+			return this->allocationCount;
+		}
+
+		//----------
+		template<typename PixelType>
+		void FramePool<PixelType>::clear() {
+			//frames still held by readers stay alive until they are dropped
+			this->frames.clear();
+			this->next = 0;
+		}
+
+		//----------
+		template class Frame<unsigned char>;
+		template class Frame<unsigned short>;
+		template class FramePool<unsigned char>;
+		template class FramePool<unsigned short>;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ofPixels.h"
+
+#include <Kinect.h>
+#include <memory>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+		// Snapshot of one frame of an image source. Sources hand these out as shared_ptr<const Frame>, so any
+		// number of consumers (e.g. on other threads) can hold on to a frame without copying it, while the
+		// source moves on to the next one.
+		template<typename PixelType>
+		class Frame {
+		public:
+			Frame();
+
+			ofPixels_<PixelType> pixels;
+			INT64 relativeTime; // Kinect clock, 100ns ticks
+			uint64_t frameIndex; // counts the frames of the source, to notice skipped frames
+			float horizontalFieldOfView;
+			float verticalFieldOfView;
+		};
+
+		// Recycles frames once all their readers have dropped them, so that the steady state reuses the same
+		// few pixel buffers. acquire() must be called from one thread (the source's), releasing is thread safe.
+		template<typename PixelType>
+		class FramePool {
+		public:
+			FramePool(size_t capacity = 8);
+
+			// A frame nobody else holds, to be filled before handing it out. When more than capacity frames are
+			// in use, a frame outside the pool is returned (and counted in getAllocationCount).
+			std::shared_ptr<Frame<PixelType>> acquire();
+
+			void setCapacity(size_t);
+			size_t getCapacity() const;
+			size_t getAllocationCount() const;
+			void clear();
+		protected:
+			std::vector<std::shared_ptr<Frame<PixelType>>> frames;
+			size_t capacity;
+			size_t next;
+			size_t allocationCount;
+		};
+	}
+}
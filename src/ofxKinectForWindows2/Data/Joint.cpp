@@ -2,6 +2,25 @@
 
 namespace ofxKinectForWindows2 {
 	namespace Data {
+		//----------
+		Joint::Joint() : Joint(JointType_SpineBase) {
+
+		}
+
+		//----------
+		Joint::Joint(JointType type) {
+			this->type = type;
+			this->trackingState = TrackingState_NotTracked;
+
+			this->joint.JointType = type;
+			this->joint.Position.X = this->joint.Position.Y = this->joint.Position.Z = 0.0f;
+			this->joint.TrackingState = TrackingState_NotTracked;
+
+			this->jointOrientation.JointType = type;
+			this->jointOrientation.Orientation.x = this->jointOrientation.Orientation.y = this->jointOrientation.Orientation.z = 0.0f;
+			this->jointOrientation.Orientation.w = 1.0f;
+		}
+
 		//----------
 		Joint::Joint(const _Joint& joint, const _JointOrientation& jointOrientation, ICoordinateMapper * coordinateMapper) {
 			this->set(joint, jointOrientation, coordinateMapper);
@@ -51,6 +70,9 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		ofVec2f Joint::getProjected(ICoordinateMapper * coordinateMapper, ProjectionCoordinates proj) const {
+			if (!coordinateMapper) {
+				return ofVec2f();
+			}
 			switch (proj) {
 			case ColorCamera: {
 				ColorSpacePoint projected = { 0 };
@@ -77,6 +99,29 @@ namespace ofxKinectForWindows2 {
 			return trackingState;
 		}
 
+		//----------
+		void Joint::setPositionInWorld(const ofVec3f & positionInWorld) {
+			this->positionInWorld = positionInWorld;
+			this->joint.Position.X = positionInWorld.x;
+			this->joint.Position.Y = positionInWorld.y;
+			this->joint.Position.Z = positionInWorld.z;
+		}
+
+		//----------
+		void Joint::setOrientation(const ofQuaternion & orientation) {
+			this->orientation = orientation;
+			this->jointOrientation.Orientation.x = orientation.x();
+			this->jointOrientation.Orientation.y = orientation.y();
+			this->jointOrientation.Orientation.z = orientation.z();
+			this->jointOrientation.Orientation.w = orientation.w();
+		}
+
+		//----------
+		void Joint::setTrackingState(TrackingState trackingState) {
+			this->trackingState = trackingState;
+			this->joint.TrackingState = trackingState;
+		}
+
 		//----------
 		_Joint Joint::getRawJoint() const {
 			return this->joint;
@@ -98,5 +143,118 @@ namespace ofxKinectForWindows2 {
 
 			return copy;
 		}
+
+#pragma mark JointMap
+		//----------
+		JointMap::JointMap() {
+			for (int i = 0; i < JointType_Count; i++) {
+				this->entries[i].first = (JointType) i;
+				this->entries[i].second = Joint((JointType) i);
+			}
+			this->mask = 0;
+		}
+
+		//----------
+		Joint & JointMap::operator[](JointType type) {
+			if (!this->has(type)) {
+				this->entries[type].second = Joint(type);
+				this->mask |= 1 << type;
+			}
+			return this->entries[type].second;
+		}
+
+		//----------
+		Joint & JointMap::at(JointType type) {
+			if (!this->has(type)) {
+				throw std::out_of_range("JointMap::at : joint not set");
+			}
+			return this->entries[type].second;
+		}
+
+		//----------
+		const Joint & JointMap::at(JointType type) const {
+			if (!this->has(type)) {
+				throw std::out_of_range("JointMap::at : joint not set");
+			}
+			return this->entries[type].second;
+		}
+
+		//----------
+		JointMap::iterator JointMap::find(JointType type) {
+			return this->has(type) ? iterator(this->entries, this->mask, type) : this->end();
+		}
+
+		//----------
+		JointMap::const_iterator JointMap::find(JointType type) const {
+			return this->has(type) ? const_iterator(this->entries, this->mask, type) : this->end();
+		}
+
+		//----------
+		size_t JointMap::count(JointType type) const {
+			return this->has(type) ? 1 : 0;
+		}
+
+		//----------
+		std::pair<JointMap::iterator, bool> JointMap::insert(const value_type & value) {
+			//like std::map, an existing joint is left as it is
+			if (this->has(value.first)) {
+				return std::make_pair(this->find(value.first), false);
+			}
+			this->set(value.first, value.second);
+			return std::make_pair(this->find(value.first), true);
+		}
+
+		//----------
+		size_t JointMap::erase(JointType type) {
+			if (!this->has(type)) {
+				return 0;
+			}
+			this->mask &= ~(1 << type);
+			return 1;
+		}
+
+		//----------
+		bool JointMap::has(JointType type) const {
+			return type >= 0 && type < JointType_Count && (this->mask & (1 << type));
+		}
+
+		//----------
+		size_t JointMap::size() const {
+			size_t count = 0;
+			for (auto bits = this->mask; bits; bits &= bits - 1) {
+				count++;
+			}
+			return count;
+		}
+
+		//----------
+		bool JointMap::empty() const {
+			return this->mask == 0;
+		}
+
+		//----------
+		void JointMap::clear() {
+			this->mask = 0;
+		}
+
+		//----------
+		JointMap::operator std::map<JointType, Joint>() const {
+			std::map<JointType, Joint> joints;
+			for (const auto & joint : *this) {
+				joints.insert(joint);
+			}
+			return joints;
+		}
+
+		//----------
+		const Joint & JointMap::get(JointType type) const {
+			return this->entries[type].second;
+		}
+
+		//----------
+		void JointMap::set(JointType type, const Joint & joint) {
+			this->entries[type].second = joint;
+			this->mask |= 1 << type;
+		}
 	}
 }
\ No newline at end of file
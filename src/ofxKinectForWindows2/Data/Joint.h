@@ -17,7 +17,8 @@ namespace ofxKinectForWindows2 {
 		class Joint
 		{
 		public:
-			Joint(){}
+			Joint();
+			Joint(JointType);
 			Joint(const _Joint& joint, const _JointOrientation& jointOrientation, ICoordinateMapper *);
 			Joint(const _Joint& joint, const _JointOrientation& jointOrientation, const ofVec2f & positionInDepthMap);
 			void set(const _Joint& joint, const _JointOrientation& jointOrientation, ICoordinateMapper *);
@@ -32,6 +33,11 @@ namespace ofxKinectForWindows2 {
 			ofQuaternion getOrientation() const;
 			TrackingState getTrackingState() const;
 
+			// Also update the raw joint data, e.g. after filtering or resampling
+			void setPositionInWorld(const ofVec3f &);
+			void setOrientation(const ofQuaternion &);
+			void setTrackingState(TrackingState);
+
 			_Joint getRawJoint() const;
 			_JointOrientation getRawJointOrientation() const;
 
@@ -47,5 +53,86 @@ namespace ofxKinectForWindows2 {
 			_Joint joint;
 			_JointOrientation jointOrientation;
 		};
+
+		// Fixed size joint storage indexed by JointType.
+		// Exposes the std::map<JointType, Joint> interface that existing code uses (operator[], at, find,
+		// count, insert, erase, iteration over pairs), but never allocates. Only joints which have been set
+		// are visited when iterating, like in the map it replaces. Code which needs an actual std::map
+		// (e.g. a function taking one) can convert, which copies.
+		class JointMap {
+		public:
+			typedef std::pair<JointType, Joint> value_type;
+
+			template<typename ValueType>
+			class Iterator {
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef ValueType value_type;
+				typedef ptrdiff_t difference_type;
+				typedef ValueType * pointer;
+				typedef ValueType & reference;
+
+				Iterator(ValueType * entries, uint32_t mask, int index) : entries(entries), mask(mask), index(index) {
+					this->skip();
+				}
+				ValueType & operator*() const { return this->entries[this->index]; }
+				ValueType * operator->() const { return &this->entries[this->index]; }
+				Iterator & operator++() {
+					this->index++;
+					this->skip();
+					return *this;
+				}
+				Iterator operator++(int) {
+					auto copy = *this;
+					++(*this);
+					return copy;
+				}
+				bool operator==(const Iterator & other) const { return this->index == other.index; }
+				bool operator!=(const Iterator & other) const { return this->index != other.index; }
+			protected:
+				void skip() {
+					while (this->index < JointType_Count && !(this->mask & (1 << this->index))) {
+						this->index++;
+					}
+				}
+				ValueType * entries;
+				uint32_t mask;
+				int index;
+			};
+			typedef Iterator<value_type> iterator;
+			typedef Iterator<const value_type> const_iterator;
+
+			JointMap();
+
+			Joint & operator[](JointType);
+			Joint & at(JointType);
+			const Joint & at(JointType) const;
+
+			iterator find(JointType);
+			const_iterator find(JointType) const;
+			size_t count(JointType) const;
+			bool has(JointType) const;
+
+			iterator begin() { return iterator(this->entries, this->mask, 0); }
+			iterator end() { return iterator(this->entries, this->mask, JointType_Count); }
+			const_iterator begin() const { return const_iterator(this->entries, this->mask, 0); }
+			const_iterator end() const { return const_iterator(this->entries, this->mask, JointType_Count); }
+
+			std::pair<iterator, bool> insert(const value_type &);
+			size_t erase(JointType);
+
+			size_t size() const;
+			bool empty() const;
+			void clear();
+
+			operator std::map<JointType, Joint>() const;
+
+			// Direct access to the contiguous storage (all JointType_Count entries, set or not)
+			const Joint & get(JointType) const;
+			void set(JointType, const Joint &);
+		protected:
+			value_type entries[JointType_Count];
+			uint32_t mask;
+		};
 	}
 }
@@ -0,0 +1,159 @@
+#include "PixelBufferPool.h"
+
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+#pragma mark PixelBufferPool
+		//----------
+		PixelBufferPool::PixelBufferPool() {
+			this->allocationCount = 0;
+			this->reuseCount = 0;
+			this->allocatedBytes = 0;
+		}
+
+		//----------
+		PixelBufferPool::~PixelBufferPool() {
+			this->trim();
+		}
+
+		//----------
+		PixelBufferPool & PixelBufferPool::getDefault() {
+			//never destroyed, sources in static objects may give their buffers back after exit
+			static auto pool = new PixelBufferPool();
+			return *pool;
+		}
+
+		//----------
+		void * PixelBufferPool::acquire(size_t size) {
+			size = getPaddedSize(size);
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				auto findBuffer = this->available.find(size);
+				if (findBuffer != this->available.end()) {
+					auto buffer = findBuffer->second;
+					this->available.erase(findBuffer);
+					this->reuseCount++;
+					return buffer;
+				}
+			}
+
+			auto buffer = allocateAligned(size);
+			if (buffer) {
+				this->allocationCount++;
+				this->allocatedBytes += size;
+			}
+			return buffer;
+		}
+
+		//----------
+		void PixelBufferPool::release(void * buffer, size_t size) {
+			if (!buffer) {
+				return;
+			}
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->available.insert(std::make_pair(getPaddedSize(size), buffer));
+		}
+
+		//----------
+		void PixelBufferPool::trim() {
+			std::lock_guard<std::mutex> lock(this->mutex);
+			for (auto & buffer : this->available) {
+				freeAligned(buffer.second);
+				this->allocatedBytes -= buffer.first;
+			}
+			this->available.clear();
+		}
+
+		//----------
+		size_t PixelBufferPool::getPaddedSize(size_t size) {
+			return (size + Alignment - 1) / Alignment * Alignment + Alignment;
+		}
+
+		//----------
+		uint64_t PixelBufferPool::getAllocationCount() const {
+			return this->allocationCount;
+		}
+
+		//----------
+		uint64_t PixelBufferPool::getReuseCount() const {
+			return this->reuseCount;
+		}
+
+		//----------
+		size_t PixelBufferPool::getAllocatedBytes() const {
+			return this->allocatedBytes;
+		}
+
+		//----------
+		void * PixelBufferPool::allocateAligned(size_t size) {
+#ifdef _MSC_VER
+			return _aligned_malloc(size, Alignment);
+#else
+			void * buffer = nullptr;
+			return posix_memalign(&buffer, Alignment, size) == 0 ? buffer : nullptr;
+#endif
+		}
+
+		//----------
+		void PixelBufferPool::freeAligned(void * buffer) {
+#ifdef _MSC_VER
+			_aligned_free(buffer);
+#else
+			free(buffer);
+#endif
+		}
+
+#pragma mark PooledPixels
+		//----------
+		template<typename PixelType>
+		PooledPixels<PixelType>::PooledPixels(PixelBufferPool & pool) :
+			pool(pool) {
+			this->buffer = nullptr;
+			this->size = 0;
+		}
+
+		//----------
+		template<typename PixelType>
+		PooledPixels<PixelType>::~PooledPixels() {
+			this->pool.release(this->buffer, this->size);
+		}
+
+		//----------
+		template<typename PixelType>
+		bool PooledPixels<PixelType>::allocate(ofPixels_<PixelType> & pixels, int width, int height, ofPixelFormat pixelFormat) {
+			if (this->buffer && pixels.getData() == this->buffer
+				&& pixels.getWidth() == width && pixels.getHeight() == height && pixels.getPixelFormat() == pixelFormat) {
+				return false;
+			}
+
+			const auto size = ofPixels_<PixelType>::bytesFromPixelFormat(width, height, pixelFormat);
+			if (!this->buffer || size != this->size) {
+				this->pool.release(this->buffer, this->size);
+				this->buffer = (PixelType *) this->pool.acquire(size);
+				this->size = size;
+			}
+			pixels.setFromExternalPixels(this->buffer, width, height, pixelFormat);
+			return true;
+		}
+
+		//----------
+		template<typename PixelType>
+		void PooledPixels<PixelType>::release(ofPixels_<PixelType> & pixels) {
+			if (pixels.getData() == this->buffer) {
+				pixels.clear();
+			}
+			this->pool.release(this->buffer, this->size);
+			this->buffer = nullptr;
+			this->size = 0;
+		}
+
+		//----------
+		template class PooledPixels<unsigned char>;
+		template class PooledPixels<unsigned short>;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ofPixels.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Data {
+		// Aligned memory for the pixels of the sources, recycled by size so that reopening a source or toggling
+		// a stream doesn't go back to the heap. Buffers start on an Alignment boundary and are padded to a whole
+		// number of Alignment blocks plus one, so SIMD kernels can use aligned loads and run past the last pixel.
+		// Rows stay contiguous (ofPixels has no stride); the rows of every Kinect stream are already a multiple
+		// of 64 bytes (512 x 2, 512 x 1, 1920 x 4, 1920 x 2), so they all start aligned too.
+		class PixelBufferPool {
+		public:
+			enum { Alignment = 64 };
+
+			PixelBufferPool();
+			~PixelBufferPool();
+
+			// Shared pool used by the sources
+			static PixelBufferPool & getDefault();
+
+			// Buffer of at least size bytes (see getPaddedSize)
+			void * acquire(size_t size);
+			// Gives a buffer back for reuse, size is the size it was acquired with
+			void release(void * buffer, size_t size);
+			// Frees the buffers waiting for reuse
+			void trim();
+
+			static size_t getPaddedSize(size_t size);
+
+			// Buffers taken from the heap. Stays constant once the sources run at a fixed resolution.
+			uint64_t getAllocationCount() const;
+			// Buffers handed out again instead of allocated
+			uint64_t getReuseCount() const;
+			// Bytes held, in use or waiting for reuse
+			size_t getAllocatedBytes() const;
+		protected:
+			PixelBufferPool(const PixelBufferPool &) = delete;
+			PixelBufferPool & operator=(const PixelBufferPool &) = delete;
+
+			static void * allocateAligned(size_t size);
+			static void freeAligned(void *);
+
+			mutable std::mutex mutex;
+			std::multimap<size_t, void *> available;
+			std::atomic<uint64_t> allocationCount;
+			std::atomic<uint64_t> reuseCount;
+			std::atomic<size_t> allocatedBytes;
+		};
+
+		// An ofPixels_ whose memory comes from a PixelBufferPool (via setFromExternalPixels). The pixels are
+		// only pointed at a new buffer when their size or format changes, never because of texture state.
+		template<typename PixelType>
+		class PooledPixels {
+		public:
+			PooledPixels(PixelBufferPool & = PixelBufferPool::getDefault());
+			~PooledPixels();
+
+			// Returns true if the pixels were pointed at a new buffer (their content is then undefined)
+			bool allocate(ofPixels_<PixelType> &, int width, int height, ofPixelFormat);
+			void release(ofPixels_<PixelType> &);
+		protected:
+			PooledPixels(const PooledPixels &) = delete;
+			PooledPixels & operator=(const PooledPixels &) = delete;
+
+			PixelBufferPool & pool;
+			PixelType * buffer;
+			size_t size;
+		};
+	}
+}
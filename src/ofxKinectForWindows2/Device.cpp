@@ -3,7 +3,7 @@
 
 #include "ofConstants.h"
 
-#define CHECK_OPEN if(!this->sensor) { OFXKINECTFORWINDOWS2_ERROR << "Failed : Sensor is not open"; }
+#define CHECK_OPEN if(!this->sensor && !this->client) { OFXKINECTFORWINDOWS2_ERROR << "Failed : Sensor is not open"; }
 
 namespace ofxKinectForWindows2 {
 	//----------
@@ -34,10 +34,24 @@ namespace ofxKinectForWindows2 {
 		}
 	}
 
+	//----------
+	void Device::openRemote(const string & host, int port) {
+		this->close();
+		auto client = make_shared<Network::Client>();
+		if (client->connect(host, port)) {
+			this->client = client;
+		}
+	}
+
 	//----------
 	void Device::close() {
 		SafeRelease(this->reader);
 
+		if (this->client) {
+			this->sources.clear();
+			this->client.reset();
+		}
+
 		if (!this->sensor) {
 			return;
 		}
@@ -51,6 +65,9 @@ namespace ofxKinectForWindows2 {
 
 	//----------
 	bool Device::isOpen() const {
+		if (this->client) {
+			return this->client->isConnected();
+		}
 		if (!this->sensor) {
 			return false;
 		}
@@ -63,6 +80,11 @@ namespace ofxKinectForWindows2 {
 		}
 	}
 	
+	//----------
+	bool Device::isRemote() const {
+		return this->client.get() != nullptr;
+	}
+
 	//----------
 	void Device::initMultiSource(std::initializer_list<FrameSourceTypes> frameSourceTypes) {
 		CHECK_OPEN;
@@ -73,7 +95,8 @@ namespace ofxKinectForWindows2 {
 				enabledFrameSourceTypes |= frameSourceType;
 			}
 			try {
-				if (!FAILED(this->sensor->OpenMultiSourceFrameReader(enabledFrameSourceTypes, &reader))) {
+				// a remote device has no reader, its sources are fed by the client
+				if (this->client || !FAILED(this->sensor->OpenMultiSourceFrameReader(enabledFrameSourceTypes, &reader))) {
 					if (enabledFrameSourceTypes & FrameSourceTypes_Color) {
 						this->initSource<Source::Color>(false);
 					}
@@ -116,8 +139,11 @@ namespace ofxKinectForWindows2 {
 		//if not then open it
 		try {
 			auto source = MAKE(SourceType);
-			source->init(this->sensor, initReader);
+			source->init(this->sensor, initReader && !this->client);
 			this->sources.push_back(source);
+			if (this->client) {
+				this->client->subscribe(this->sources);
+			}
 			return source;
 		} catch (std::exception & e) {
 			OFXKINECTFORWINDOWS2_ERROR << e.what();
@@ -199,8 +225,11 @@ namespace ofxKinectForWindows2 {
 
 		//check if it already exists
 		auto source = this->getSource<SourceType>();
-		if (source && source->hasReader()) {
+		if (source && (source->hasReader() || this->client)) {
 			this->sources.erase(std::remove(this->sources.begin(), this->sources.end(), source), this->sources.end());
+			if (this->client) {
+				this->client->subscribe(this->sources);
+			}
 			return true;
 		}
 
@@ -242,6 +271,17 @@ namespace ofxKinectForWindows2 {
 	//----------
 	void Device::update() {
 		this->isFrameNewFlag = false;
+		if (this->client) {
+			this->client->update(this->sources);
+			for (auto source : this->sources) {
+				this->isFrameNewFlag |= source->isFrameNew();
+			}
+			if (this->sharedMemoryPublisher && this->isFrameNewFlag) {
+				this->sharedMemoryPublisher->publish(*this);
+			}
+			return;
+		}
+
 		IMultiSourceFrame * frame = NULL;
 		if (this->reader) {
 			try {
@@ -262,6 +302,10 @@ namespace ofxKinectForWindows2 {
 			this->isFrameNewFlag |= source->isFrameNew();
 		}
 		SafeRelease(frame);
+
+		if (this->sharedMemoryPublisher && this->isFrameNewFlag) {
+			this->sharedMemoryPublisher->publish(*this);
+		}
 	}
 
 	//----------
@@ -269,6 +313,26 @@ namespace ofxKinectForWindows2 {
 		return this->isFrameNewFlag;
 	}
 
+	//----------
+	shared_ptr<SharedMemory::Publisher> Device::openSharedMemoryPublisher(const string & name) {
+		auto publisher = make_shared<SharedMemory::Publisher>();
+		if (!publisher->open(name)) {
+			return shared_ptr<SharedMemory::Publisher>();
+		}
+		this->sharedMemoryPublisher = publisher;
+		return publisher;
+	}
+
+	//----------
+	void Device::closeSharedMemoryPublisher() {
+		this->sharedMemoryPublisher.reset();
+	}
+
+	//----------
+	shared_ptr<SharedMemory::Publisher> Device::getSharedMemoryPublisher() const {
+		return this->sharedMemoryPublisher;
+	}
+
 	//----------
 	const vector<shared_ptr<Source::Base>> & Device::getSources() const {
 		return this->sources;
@@ -7,6 +7,8 @@
 #include "Source/LongExposureInfrared.h"
 #include "Source/BodyIndex.h"
 #include "Source/Body.h"
+#include "Network/Client.h"
+#include "SharedMemory/Publisher.h"
 
 #include <memory>
 #include <vector>
@@ -18,8 +20,12 @@ namespace ofxKinectForWindows2 {
 		virtual ~Device();
 		
 		void open();
+		// Use the frames of a Network::Server on another machine instead of a local sensor.
+		// Sources are initialised as usual, coordinate mapping and gesture databases need a local sensor.
+		void openRemote(const string & host, int port = Network::DefaultPort);
 		void close();
 		bool isOpen() const;
+		bool isRemote() const;
 
 		void initMultiSource(std::initializer_list<FrameSourceTypes> frameSourceTypes);
 
@@ -44,6 +50,11 @@ namespace ofxKinectForWindows2 {
 		void update();
 		bool isFrameNew() const;
 
+		// Copy new frames into shared memory at the end of each update(), for SharedMemory::Reader in other processes
+		shared_ptr<SharedMemory::Publisher> openSharedMemoryPublisher(const string & name = SharedMemory::getDefaultName());
+		void closeSharedMemoryPublisher();
+		shared_ptr<SharedMemory::Publisher> getSharedMemoryPublisher() const;
+
 		template<typename SourceType>
 		bool hasSource() const {
 			if (this->getSource<SourceType>()) {
@@ -87,6 +98,8 @@ namespace ofxKinectForWindows2 {
 
 		IKinectSensor * sensor;
 		IMultiSourceFrameReader * reader;
+		shared_ptr<Network::Client> client;
+		shared_ptr<SharedMemory::Publisher> sharedMemoryPublisher;
 
 		vector<shared_ptr<Source::Base>> sources;
 		bool isFrameNewFlag;
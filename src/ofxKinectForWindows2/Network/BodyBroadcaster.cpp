@@ -0,0 +1,165 @@
+#include "BodyBroadcaster.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		BodyBroadcaster::BodyBroadcaster() {
+			this->keyframeInterval = 10;
+			this->sequence = 0;
+			this->sentPacketCount = 0;
+			this->sentByteCount = 0;
+			this->sentKeyframeCount = 0;
+			for (auto & keyframe : this->keyframes) {
+				keyframe.trackingId = 0;
+			}
+		}
+
+		//----------
+		bool BodyBroadcaster::open(const string & host, int port) {
+			this->close();
+			if (!this->socket.openDatagram(host, port)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Couldn't open UDP socket to " << host << ":" << port;
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		void BodyBroadcaster::close() {
+			this->socket.close();
+			for (auto & keyframe : this->keyframes) {
+				keyframe.trackingId = 0;
+			}
+		}
+
+		//----------
+		bool BodyBroadcaster::isOpen() const {
+			return this->socket.isOpen();
+		}
+
+		//----------
+		void BodyBroadcaster::setKeyframeInterval(int frames) {
+			this->keyframeInterval = max(frames, 1);
+		}
+
+		//----------
+		int BodyBroadcaster::getKeyframeInterval() const {
+			return this->keyframeInterval;
+		}
+
+		//----------
+		void BodyBroadcaster::send(const Source::Body & source) {
+			source.getRawFrame(this->rawFrame);
+			this->send(this->rawFrame);
+		}
+
+		//----------
+		void BodyBroadcaster::send(const vector<Data::Body> & bodies, INT64 relativeTime) {
+			memset(&this->rawFrame, 0, sizeof(this->rawFrame));
+			this->rawFrame.relativeTime = relativeTime;
+			for (const auto & body : bodies) {
+				const int i = body.bodyId;
+				if (i >= BODY_COUNT || !body.tracked) {
+					continue;
+				}
+				this->rawFrame.tracked[i] = true;
+				this->rawFrame.trackingIds[i] = body.trackingId;
+				this->rawFrame.leftHandStates[i] = body.leftHandState;
+				this->rawFrame.rightHandStates[i] = body.rightHandState;
+				for (int j = 0; j < JointType_Count; j++) {
+					const auto & joint = body.joints.get((JointType) j);
+					this->rawFrame.joints[i * JointType_Count + j] = joint.getRawJoint();
+					this->rawFrame.jointOrientations[i * JointType_Count + j] = joint.getRawJointOrientation();
+				}
+			}
+			this->send(this->rawFrame);
+		}
+
+		//----------
+		void BodyBroadcaster::send(const Source::Body::RawFrame & rawFrame) {
+			if (!this->isOpen()) {
+				return;
+			}
+
+			BodyPacket packet;
+			packet.sequence = ++this->sequence;
+			packet.relativeTime = rawFrame.relativeTime;
+			packet.trackedMask = 0;
+			for (int i = 0; i < BODY_COUNT; i++) {
+				if (rawFrame.tracked[i]) {
+					packet.trackedMask |= 1 << i;
+				}
+				else {
+					this->keyframes[i].trackingId = 0;
+				}
+			}
+
+			uint8_t buffer[BodyPacketMaxSize];
+			auto sendPacket = [&]() {
+				const auto size = packet.write(buffer, this->keyframes[packet.bodyIndex == BodyPacketNoBody ? 0 : packet.bodyIndex].positions);
+				if (this->socket.sendDatagram(buffer, size)) {
+					this->sentPacketCount++;
+					this->sentByteCount += size;
+					if (packet.keyframe) {
+						this->sentKeyframeCount++;
+					}
+				}
+			};
+
+			//receivers still need to hear that everyone left
+			if (packet.trackedMask == 0) {
+				packet.keyframe = false;
+				packet.keyframeSequence = 0;
+				packet.bodyIndex = BodyPacketNoBody;
+				sendPacket();
+				return;
+			}
+
+			for (int i = 0; i < BODY_COUNT; i++) {
+				if (!rawFrame.tracked[i]) {
+					continue;
+				}
+				auto & keyframe = this->keyframes[i];
+				const auto joints = rawFrame.joints + i * JointType_Count;
+				const auto jointOrientations = rawFrame.jointOrientations + i * JointType_Count;
+
+				packet.bodyIndex = i;
+				packet.trackingId = rawFrame.trackingIds[i];
+				packet.leftHandState = rawFrame.leftHandStates[i];
+				packet.rightHandState = rawFrame.rightHandStates[i];
+				for (int j = 0; j < JointType_Count; j++) {
+					packet.trackingStates[j] = joints[j].TrackingState;
+					packet.positions[j][0] = BodyPacket::quantizePosition(joints[j].Position.X);
+					packet.positions[j][1] = BodyPacket::quantizePosition(joints[j].Position.Y);
+					packet.positions[j][2] = BodyPacket::quantizePosition(joints[j].Position.Z);
+					packet.orientations[j] = BodyPacket::packOrientation(jointOrientations[j].Orientation);
+				}
+
+				packet.keyframe = keyframe.trackingId != packet.trackingId || ++keyframe.framesSince >= this->keyframeInterval;
+				if (packet.keyframe) {
+					keyframe.trackingId = packet.trackingId;
+					keyframe.sequence = packet.sequence;
+					keyframe.framesSince = 0;
+					memcpy(keyframe.positions, packet.positions, sizeof(keyframe.positions));
+				}
+				packet.keyframeSequence = keyframe.sequence;
+				sendPacket();
+			}
+		}
+
+		//----------
+		uint64_t BodyBroadcaster::getSentPacketCount() const {
+			return this->sentPacketCount;
+		}
+
+		//----------
+		uint64_t BodyBroadcaster::getSentByteCount() const {
+			return this->sentByteCount;
+		}
+
+		//----------
+		uint64_t BodyBroadcaster::getSentKeyframeCount() const {
+			return this->sentKeyframeCount;
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "BodyPacket.h"
+#include "Socket.h"
+#include "../Source/Body.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Sends bodies as small UDP datagrams (see BodyPacket.h), e.g. to drive visuals on other machines on the LAN.
+		// Each tracked body is sent as a keyframe every keyframeInterval frames, and as deltas against that keyframe
+		// in between, so a lost datagram only costs the frames until the next keyframe.
+		class BodyBroadcaster {
+		public:
+			BodyBroadcaster();
+
+			// The default host broadcasts to the local network
+			bool open(const string & host = "255.255.255.255", int port = DefaultBodyPort);
+			void close();
+			bool isOpen() const;
+
+			void setKeyframeInterval(int frames);
+			int getKeyframeInterval() const;
+
+			void send(const Source::Body &);
+			// e.g. bodies after Processing::BodyFilter
+			void send(const vector<Data::Body> &, INT64 relativeTime);
+			void send(const Source::Body::RawFrame &);
+
+			uint64_t getSentPacketCount() const;
+			uint64_t getSentByteCount() const;
+			// Packets carrying a whole body, the rest are deltas
+			uint64_t getSentKeyframeCount() const;
+		protected:
+			struct Keyframe {
+				UINT64 trackingId;
+				uint32_t sequence;
+				int framesSince;
+				int16_t positions[JointType_Count][3];
+			};
+
+			Socket socket;
+			int keyframeInterval;
+			uint32_t sequence;
+			Keyframe keyframes[BODY_COUNT];
+			Source::Body::RawFrame rawFrame;
+
+			uint64_t sentPacketCount;
+			uint64_t sentByteCount;
+			uint64_t sentKeyframeCount;
+		};
+	}
+}
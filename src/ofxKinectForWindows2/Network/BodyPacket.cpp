@@ -0,0 +1,227 @@
+#include "BodyPacket.h"
+
+#include <cmath>
+#include <cstring>
+
+#define BODY_PACKET_HEADER_SIZE 22
+#define SMALLEST_THREE_RANGE 0.70710678f // components other than the largest are within +/- 1/sqrt(2)
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		template<typename T>
+		static inline void writeValue(uint8_t *& data, T value) {
+			memcpy(data, &value, sizeof(T));
+			data += sizeof(T);
+		}
+
+		//----------
+		template<typename T>
+		static inline T readValue(const uint8_t *& data) {
+			T value;
+			memcpy(&value, data, sizeof(T));
+			data += sizeof(T);
+			return value;
+		}
+
+		//----------
+		size_t BodyPacket::write(uint8_t * data, const int16_t (*keyframePositions)[3]) const {
+			uint8_t * start = data;
+			writeValue<uint16_t>(data, BodyPacketMagic);
+			writeValue<uint8_t>(data, BodyPacketVersion);
+			writeValue<uint8_t>(data, this->keyframe ? BodyPacketKeyframe : 0);
+			writeValue<uint32_t>(data, this->sequence);
+			writeValue<uint32_t>(data, this->keyframeSequence);
+			writeValue<int64_t>(data, this->relativeTime);
+			writeValue<uint8_t>(data, this->trackedMask);
+			writeValue<uint8_t>(data, this->bodyIndex);
+			if (this->bodyIndex == BodyPacketNoBody) {
+				return data - start;
+			}
+
+			writeValue<uint64_t>(data, this->trackingId);
+			writeValue<uint8_t>(data, (uint8_t) ((this->leftHandState & 0xF) | ((this->rightHandState & 0xF) << 4)));
+
+			uint8_t states[7] = { 0 };
+			for (int j = 0; j < JointType_Count; j++) {
+				states[j / 4] |= (this->trackingStates[j] & 3) << ((j % 4) * 2);
+			}
+			memcpy(data, states, sizeof(states));
+			data += sizeof(states);
+
+			if (this->keyframe) {
+				for (int j = 0; j < JointType_Count; j++) {
+					for (int axis = 0; axis < 3; axis++) {
+						writeValue<int16_t>(data, this->positions[j][axis]);
+					}
+				}
+			}
+			else {
+				//joints which moved less than 12.7cm since the keyframe fit in a byte per axis
+				uint32_t smallMask = 0;
+				for (int j = 0; j < JointType_Count; j++) {
+					bool small = true;
+					for (int axis = 0; axis < 3; axis++) {
+						const int offset = this->positions[j][axis] - keyframePositions[j][axis];
+						small &= offset >= -127 && offset <= 127;
+					}
+					if (small) {
+						smallMask |= 1u << j;
+					}
+				}
+				writeValue<uint32_t>(data, smallMask);
+				for (int j = 0; j < JointType_Count; j++) {
+					for (int axis = 0; axis < 3; axis++) {
+						if (smallMask & (1u << j)) {
+							writeValue<int8_t>(data, (int8_t) (this->positions[j][axis] - keyframePositions[j][axis]));
+						}
+						else {
+							writeValue<int16_t>(data, this->positions[j][axis]);
+						}
+					}
+				}
+			}
+
+			for (int j = 0; j < JointType_Count; j++) {
+				writeValue<uint32_t>(data, this->orientations[j]);
+			}
+			return data - start;
+		}
+
+		//----------
+		bool BodyPacket::readHeader(const uint8_t * data, size_t size) {
+			if (size < BODY_PACKET_HEADER_SIZE) {
+				return false;
+			}
+			if (readValue<uint16_t>(data) != BodyPacketMagic || readValue<uint8_t>(data) != BodyPacketVersion) {
+				return false;
+			}
+			this->keyframe = (readValue<uint8_t>(data) & BodyPacketKeyframe) != 0;
+			this->sequence = readValue<uint32_t>(data);
+			this->keyframeSequence = readValue<uint32_t>(data);
+			this->relativeTime = readValue<int64_t>(data);
+			this->trackedMask = readValue<uint8_t>(data);
+			this->bodyIndex = readValue<uint8_t>(data);
+			return this->bodyIndex == BodyPacketNoBody || this->bodyIndex < BODY_COUNT;
+		}
+
+		//----------
+		bool BodyPacket::readBody(const uint8_t * data, size_t size, const int16_t (*keyframePositions)[3]) {
+			const uint8_t * end = data + size;
+			data += BODY_PACKET_HEADER_SIZE;
+			if (this->bodyIndex == BodyPacketNoBody || end - data < 8 + 1 + 7 + 4) {
+				return false;
+			}
+			if (!this->keyframe && !keyframePositions) {
+				return false;
+			}
+
+			this->trackingId = readValue<uint64_t>(data);
+			const uint8_t handStates = readValue<uint8_t>(data);
+			this->leftHandState = (HandState) (handStates & 0xF);
+			this->rightHandState = (HandState) (handStates >> 4);
+			for (int j = 0; j < JointType_Count; j++) {
+				this->trackingStates[j] = (TrackingState) ((data[j / 4] >> ((j % 4) * 2)) & 3);
+			}
+			data += 7;
+
+			if (this->keyframe) {
+				if (end - data < JointType_Count * (6 + 4)) {
+					return false;
+				}
+				for (int j = 0; j < JointType_Count; j++) {
+					for (int axis = 0; axis < 3; axis++) {
+						this->positions[j][axis] = readValue<int16_t>(data);
+					}
+				}
+			}
+			else {
+				const uint32_t smallMask = readValue<uint32_t>(data);
+				int positionBytes = 0;
+				for (int j = 0; j < JointType_Count; j++) {
+					positionBytes += (smallMask & (1u << j)) ? 3 : 6;
+				}
+				if (end - data < positionBytes + JointType_Count * 4) {
+					return false;
+				}
+				for (int j = 0; j < JointType_Count; j++) {
+					for (int axis = 0; axis < 3; axis++) {
+						if (smallMask & (1u << j)) {
+							this->positions[j][axis] = (int16_t) (keyframePositions[j][axis] + readValue<int8_t>(data));
+						}
+						else {
+							this->positions[j][axis] = readValue<int16_t>(data);
+						}
+					}
+				}
+			}
+
+			for (int j = 0; j < JointType_Count; j++) {
+				this->orientations[j] = readValue<uint32_t>(data);
+			}
+			return true;
+		}
+
+		//----------
+		int16_t BodyPacket::quantizePosition(float meters) {
+			const float millimeters = roundf(meters * 1000.0f);
+			return (int16_t) (millimeters < -32767.0f ? -32767.0f : (millimeters > 32767.0f ? 32767.0f : millimeters));
+		}
+
+		//----------
+		float BodyPacket::dequantizePosition(int16_t millimeters) {
+			return millimeters / 1000.0f;
+		}
+
+		//----------
+		uint32_t BodyPacket::packOrientation(const Vector4 & orientation) {
+			float components[4] = { orientation.x, orientation.y, orientation.z, orientation.w };
+			int largest = 0;
+			for (int i = 1; i < 4; i++) {
+				if (fabsf(components[i]) > fabsf(components[largest])) {
+					largest = i;
+				}
+			}
+
+			//q and -q are the same rotation, so make the dropped component positive
+			const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+			uint32_t packed = (uint32_t) largest << 30;
+			int shift = 20;
+			for (int i = 0; i < 4; i++) {
+				if (i == largest) {
+					continue;
+				}
+				float normalized = (components[i] * sign / SMALLEST_THREE_RANGE + 1.0f) * 0.5f;
+				normalized = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+				packed |= (uint32_t) (normalized * 1023.0f + 0.5f) << shift;
+				shift -= 10;
+			}
+			return packed;
+		}
+
+		//----------
+		Vector4 BodyPacket::unpackOrientation(uint32_t packed) {
+			const int largest = packed >> 30;
+			float components[4];
+			float sumSquares = 0.0f;
+			int shift = 20;
+			for (int i = 0; i < 4; i++) {
+				if (i == largest) {
+					continue;
+				}
+				const float normalized = ((packed >> shift) & 1023) / 1023.0f;
+				components[i] = (normalized * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+				sumSquares += components[i] * components[i];
+				shift -= 10;
+			}
+			components[largest] = sqrtf(sumSquares < 1.0f ? 1.0f - sumSquares : 0.0f);
+
+			Vector4 orientation;
+			orientation.x = components[0];
+			orientation.y = components[1];
+			orientation.z = components[2];
+			orientation.w = components[3];
+			return orientation;
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Kinect.h>
+#include <stdint.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Datagram layout of BodyBroadcaster, one datagram per tracked body per frame (little endian) :
+		//	header : magic u16, version u8, flags u8, sequence u32, keyframeSequence u32, relativeTime i64,
+		//		trackedMask u8 (bit per body slot), bodyIndex u8 (0xFF when no body is tracked, then the datagram ends)
+		//	body : trackingId u64, hand states u8 (left | right << 4), tracking states 2 bits per joint (7 bytes),
+		//		keyframe : JointType_Count x i16[3] positions in mm
+		//		delta : u32 mask of joints sent as i8[3] mm offsets from the body's keyframe, the others as i16[3]
+		//		JointType_Count x u32 orientations (smallest three : 2 bit index of the dropped component, 3 x 10 bits)
+		enum {
+			DefaultBodyPort = 8766,
+			BodyPacketMagic = 0x4B42,
+			BodyPacketVersion = 1,
+			BodyPacketKeyframe = 1,
+			BodyPacketNoBody = 0xFF,
+			BodyPacketMaxSize = 512
+		};
+
+		struct BodyPacket {
+			// header
+			bool keyframe;
+			uint32_t sequence;
+			uint32_t keyframeSequence;
+			INT64 relativeTime;
+			uint8_t trackedMask;
+			uint8_t bodyIndex;
+
+			// body
+			UINT64 trackingId;
+			HandState leftHandState;
+			HandState rightHandState;
+			TrackingState trackingStates[JointType_Count];
+			int16_t positions[JointType_Count][3]; // absolute, mm
+			uint32_t orientations[JointType_Count];
+
+			// Positions are written as offsets from keyframePositions unless keyframe is set. Returns the size.
+			size_t write(uint8_t * data, const int16_t (*keyframePositions)[3]) const;
+			bool readHeader(const uint8_t * data, size_t size);
+			// Delta packets need the positions of the keyframe they refer to
+			bool readBody(const uint8_t * data, size_t size, const int16_t (*keyframePositions)[3]);
+
+			static int16_t quantizePosition(float meters);
+			static float dequantizePosition(int16_t);
+			static uint32_t packOrientation(const Vector4 &);
+			static Vector4 unpackOrientation(uint32_t);
+		};
+	}
+}
@@ -0,0 +1,181 @@
+#include "BodyReceiver.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		BodyReceiver::BodyReceiver() {
+			this->hasSequence = false;
+			this->sequence = 0;
+			this->bodiesChanged = false;
+			this->receivedPacketCount = 0;
+			this->receivedKeyframeCount = 0;
+			this->discardedPacketCount = 0;
+			for (auto & keyframe : this->keyframes) {
+				keyframe.valid = false;
+			}
+			memset(&this->rawFrame, 0, sizeof(this->rawFrame));
+			this->bodies.resize(BODY_COUNT);
+			for (int i = 0; i < BODY_COUNT; i++) {
+				this->bodies[i].bodyId = i;
+			}
+		}
+
+		//----------
+		bool BodyReceiver::open(int port) {
+			this->close();
+			if (!this->socket.bindDatagram(port)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Couldn't listen for UDP on port " << port;
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		void BodyReceiver::close() {
+			this->socket.close();
+			this->hasSequence = false;
+			for (auto & keyframe : this->keyframes) {
+				keyframe.valid = false;
+			}
+		}
+
+		//----------
+		bool BodyReceiver::isOpen() const {
+			return this->socket.isOpen();
+		}
+
+		//----------
+		bool BodyReceiver::update() {
+			if (!this->isOpen()) {
+				return false;
+			}
+
+			uint8_t buffer[BodyPacketMaxSize];
+			while (this->socket.waitReadable(0)) {
+				const int size = this->socket.receiveDatagram(buffer, sizeof(buffer));
+				if (size < 0) {
+					break;
+				}
+				this->receivedPacketCount++;
+				this->receive(buffer, size);
+			}
+
+			if (!this->bodiesChanged) {
+				return false;
+			}
+			this->bodiesChanged = false;
+
+			for (int i = 0; i < BODY_COUNT; i++) {
+				auto & body = this->bodies[i];
+				body.clear();
+				body.bodyId = i;
+				body.tracked = this->rawFrame.tracked[i] != 0;
+				if (body.tracked) {
+					body.trackingId = this->rawFrame.trackingIds[i];
+					body.leftHandState = this->rawFrame.leftHandStates[i];
+					body.rightHandState = this->rawFrame.rightHandStates[i];
+					body.setJoints(this->rawFrame.joints + i * JointType_Count
+						, this->rawFrame.jointOrientations + i * JointType_Count
+						, this->rawFrame.jointsInDepthMap + i * JointType_Count);
+				}
+			}
+			return true;
+		}
+
+		//----------
+		void BodyReceiver::receive(const uint8_t * data, size_t size) {
+			auto & packet = this->packet;
+			if (!packet.readHeader(data, size)) {
+				this->discardedPacketCount++;
+				return;
+			}
+
+			//sequence numbers wrap, so compare the difference
+			const int32_t age = this->hasSequence ? (int32_t) (this->sequence - packet.sequence) : -1;
+			if (age > 0) {
+				this->discardedPacketCount++;
+				return;
+			}
+			if (age < 0) {
+				//first datagram of a newer frame, bodies not in it have left
+				this->hasSequence = true;
+				this->sequence = packet.sequence;
+				this->rawFrame.relativeTime = packet.relativeTime;
+				for (int i = 0; i < BODY_COUNT; i++) {
+					if (!(packet.trackedMask & (1 << i))) {
+						this->rawFrame.tracked[i] = false;
+						this->keyframes[i].valid = false;
+					}
+				}
+				this->bodiesChanged = true;
+			}
+			if (packet.bodyIndex == BodyPacketNoBody) {
+				return;
+			}
+
+			const int i = packet.bodyIndex;
+			auto & keyframe = this->keyframes[i];
+			const bool haveKeyframe = keyframe.valid && keyframe.sequence == packet.keyframeSequence;
+			if (!packet.readBody(data, size, haveKeyframe ? keyframe.positions : nullptr)
+				|| (!packet.keyframe && packet.trackingId != keyframe.trackingId)) {
+				this->rawFrame.tracked[i] = false;
+				this->discardedPacketCount++;
+				return;
+			}
+			if (packet.keyframe) {
+				keyframe.valid = true;
+				keyframe.trackingId = packet.trackingId;
+				keyframe.sequence = packet.sequence;
+				memcpy(keyframe.positions, packet.positions, sizeof(keyframe.positions));
+				this->receivedKeyframeCount++;
+			}
+
+			this->rawFrame.tracked[i] = true;
+			this->rawFrame.trackingIds[i] = packet.trackingId;
+			this->rawFrame.leftHandStates[i] = packet.leftHandState;
+			this->rawFrame.rightHandStates[i] = packet.rightHandState;
+			auto joints = this->rawFrame.joints + i * JointType_Count;
+			auto jointOrientations = this->rawFrame.jointOrientations + i * JointType_Count;
+			for (int j = 0; j < JointType_Count; j++) {
+				joints[j].JointType = (JointType) j;
+				joints[j].TrackingState = packet.trackingStates[j];
+				joints[j].Position.X = BodyPacket::dequantizePosition(packet.positions[j][0]);
+				joints[j].Position.Y = BodyPacket::dequantizePosition(packet.positions[j][1]);
+				joints[j].Position.Z = BodyPacket::dequantizePosition(packet.positions[j][2]);
+				jointOrientations[j].JointType = (JointType) j;
+				jointOrientations[j].Orientation = BodyPacket::unpackOrientation(packet.orientations[j]);
+			}
+			this->bodiesChanged = true;
+		}
+
+		//----------
+		const vector<Data::Body> & BodyReceiver::getBodies() const {
+			return this->bodies;
+		}
+
+		//----------
+		INT64 BodyReceiver::getRelativeTime() const {
+			return this->rawFrame.relativeTime;
+		}
+
+		//----------
+		const Source::Body::RawFrame & BodyReceiver::getRawFrame() const {
+			return this->rawFrame;
+		}
+
+		//----------
+		uint64_t BodyReceiver::getReceivedPacketCount() const {
+			return this->receivedPacketCount;
+		}
+
+		//----------
+		uint64_t BodyReceiver::getReceivedKeyframeCount() const {
+			return this->receivedKeyframeCount;
+		}
+
+		//----------
+		uint64_t BodyReceiver::getDiscardedPacketCount() const {
+			return this->discardedPacketCount;
+		}
+	}
+}
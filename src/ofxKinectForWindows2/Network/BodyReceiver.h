@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BodyPacket.h"
+#include "Socket.h"
+#include "../Source/Body.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Receives the datagrams of a BodyBroadcaster and rebuilds the bodies. Call update() every frame, it reads
+		// whatever has arrived without blocking. A body whose keyframe was lost stays untracked until the next keyframe.
+		class BodyReceiver {
+		public:
+			BodyReceiver();
+
+			bool open(int port = DefaultBodyPort);
+			void close();
+			bool isOpen() const;
+
+			// Returns true if the bodies changed
+			bool update();
+
+			// BODY_COUNT bodies, like Source::Body::getBodies()
+			const vector<Data::Body> & getBodies() const;
+			INT64 getRelativeTime() const;
+			// e.g. to feed Source::Body::update(const RawFrame &). Depth map positions are not sent and are 0.
+			const Source::Body::RawFrame & getRawFrame() const;
+
+			uint64_t getReceivedPacketCount() const;
+			// Accepted packets carrying a whole body, the rest are deltas
+			uint64_t getReceivedKeyframeCount() const;
+			// Datagrams which were malformed, arrived late, or referred to a keyframe we don't have
+			uint64_t getDiscardedPacketCount() const;
+		protected:
+			struct Keyframe {
+				UINT64 trackingId;
+				uint32_t sequence;
+				bool valid;
+				int16_t positions[JointType_Count][3];
+			};
+
+			void receive(const uint8_t * data, size_t size);
+
+			Socket socket;
+			bool hasSequence;
+			uint32_t sequence;
+			Keyframe keyframes[BODY_COUNT];
+			BodyPacket packet;
+			Source::Body::RawFrame rawFrame;
+			vector<Data::Body> bodies;
+			bool bodiesChanged;
+
+			uint64_t receivedPacketCount;
+			uint64_t receivedKeyframeCount;
+			uint64_t discardedPacketCount;
+		};
+	}
+}
@@ -0,0 +1,192 @@
+#include "Client.h"
+#include "../Source/Depth.h"
+#include "../Source/Color.h"
+#include "../Source/Infrared.h"
+#include "../Source/LongExposureInfrared.h"
+#include "../Source/BodyIndex.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		Client::Client() {
+			this->running = false;
+			this->connected = false;
+			this->receivedMessageCount = 0;
+		}
+
+		//----------
+		Client::~Client() {
+			this->close();
+		}
+
+		//----------
+		bool Client::connect(const string & host, int port) {
+			this->close();
+			if (!this->socket.connect(host, port)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Failed to connect to " << host << ":" << port;
+				return false;
+			}
+			this->connected = true;
+			this->running = true;
+			this->receiveThread = std::thread([this]() {
+				this->receiveLoop();
+			});
+			return true;
+		}
+
+		//----------
+		void Client::close() {
+			this->running = false;
+			this->socket.shutdown();
+			if (this->receiveThread.joinable()) {
+				this->receiveThread.join();
+			}
+			this->socket.close();
+			this->connected = false;
+
+			std::lock_guard<std::mutex> lock(this->latestMutex);
+			for (auto & payload : this->latest) {
+				payload.reset();
+			}
+		}
+
+		//----------
+		bool Client::isConnected() const {
+			return this->connected;
+		}
+
+		//----------
+		void Client::subscribe(int sourceFlags) {
+			if (!this->connected) {
+				return;
+			}
+			MessageHeader header;
+			header.magic = MessageMagic;
+			header.type = MessageType_Subscribe;
+			header.reserved = 0;
+			header.size = sizeof(uint32_t);
+			uint32_t subscription = (uint32_t) sourceFlags;
+
+			std::lock_guard<std::mutex> lock(this->sendMutex);
+			this->socket.sendAll(&header, sizeof(header));
+			this->socket.sendAll(&subscription, sizeof(subscription));
+		}
+
+		//----------
+		void Client::subscribe(const vector<shared_ptr<Source::Base>> & sources) {
+			int sourceFlags = 0;
+			for (auto & source : sources) {
+				if (dynamic_pointer_cast<Source::Depth>(source)) {
+					sourceFlags |= SourceFlags_Depth;
+				}
+				else if (dynamic_pointer_cast<Source::Color>(source)) {
+					sourceFlags |= SourceFlags_Color;
+				}
+				else if (dynamic_pointer_cast<Source::Infrared>(source)) {
+					sourceFlags |= SourceFlags_Infrared;
+				}
+				else if (dynamic_pointer_cast<Source::LongExposureInfrared>(source)) {
+					sourceFlags |= SourceFlags_LongExposureInfrared;
+				}
+				else if (dynamic_pointer_cast<Source::BodyIndex>(source)) {
+					sourceFlags |= SourceFlags_BodyIndex;
+				}
+				else if (dynamic_pointer_cast<Source::Body>(source)) {
+					sourceFlags |= SourceFlags_Body;
+				}
+			}
+			this->subscribe(sourceFlags);
+		}
+
+		//----------
+		void Client::update(const vector<shared_ptr<Source::Base>> & sources) {
+			Payload payloads[MessageType_Count];
+			{
+				std::lock_guard<std::mutex> lock(this->latestMutex);
+				for (int i = 0; i < MessageType_Count; i++) {
+					payloads[i].swap(this->latest[i]);
+				}
+			}
+
+			for (auto & source : sources) {
+				if (auto depth = dynamic_pointer_cast<Source::Depth>(source)) {
+					this->loadImage(*depth, payloads[MessageType_Depth], this->shortPixels);
+				}
+				else if (auto color = dynamic_pointer_cast<Source::Color>(source)) {
+					this->loadImage(*color, payloads[MessageType_Color], this->pixels);
+				}
+				else if (auto infrared = dynamic_pointer_cast<Source::Infrared>(source)) {
+					this->loadImage(*infrared, payloads[MessageType_Infrared], this->shortPixels);
+				}
+				else if (auto longExposureInfrared = dynamic_pointer_cast<Source::LongExposureInfrared>(source)) {
+					this->loadImage(*longExposureInfrared, payloads[MessageType_LongExposureInfrared], this->shortPixels);
+				}
+				else if (auto bodyIndex = dynamic_pointer_cast<Source::BodyIndex>(source)) {
+					this->loadImage(*bodyIndex, payloads[MessageType_BodyIndex], this->pixels);
+				}
+				else if (auto body = dynamic_pointer_cast<Source::Body>(source)) {
+					const auto & payload = payloads[MessageType_Body];
+					if (payload && payload->size() == sizeof(this->rawBodyFrame)) {
+						memcpy(&this->rawBodyFrame, payload->data(), sizeof(this->rawBodyFrame));
+						body->update(this->rawBodyFrame);
+					}
+					else {
+						body->clearFrameNew();
+					}
+				}
+			}
+		}
+
+		//----------
+		uint64_t Client::getReceivedMessageCount() const {
+			return this->receivedMessageCount;
+		}
+
+		//----------
+		void Client::receiveLoop() {
+			while (this->running) {
+				if (!this->socket.waitReadable(100)) {
+					continue;
+				}
+				MessageHeader header;
+				if (!this->socket.receiveAll(&header, sizeof(header))) {
+					break;
+				}
+				if (header.magic != MessageMagic || header.size > MaxMessageSize) {
+					OFXKINECTFORWINDOWS2_ERROR << "Invalid message from server";
+					break;
+				}
+				auto payload = make_shared<vector<uint8_t>>(header.size);
+				if (header.size > 0 && !this->socket.receiveAll(payload->data(), payload->size())) {
+					break;
+				}
+				this->receivedMessageCount++;
+				if (header.type > MessageType_Subscribe && header.type < MessageType_Count) {
+					std::lock_guard<std::mutex> lock(this->latestMutex);
+					this->latest[header.type] = payload;
+				}
+			}
+			this->connected = false;
+		}
+
+		//----------
+		template<typename SourceType, typename PixelType>
+		void Client::loadImage(SourceType & source, const Payload & payload, ofPixels_<PixelType> & pixels) {
+			if (!payload || payload->size() < sizeof(ImageHeader)) {
+				source.clearFrameNew();
+				return;
+			}
+			ImageHeader header;
+			memcpy(&header, payload->data(), sizeof(header));
+			const size_t size = (size_t) header.width * header.height * header.channels * header.bytesPerChannel;
+			if (header.bytesPerChannel != sizeof(PixelType) || payload->size() != sizeof(header) + size) {
+				OFXKINECTFORWINDOWS2_ERROR << "Image message doesn't match the " << source.getTypeName() << " source";
+				source.clearFrameNew();
+				return;
+			}
+			pixels.setFromPixels((const PixelType *) (payload->data() + sizeof(header)), header.width, header.height, header.channels);
+			source.loadFrame(pixels, header.relativeTime);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Message.h"
+#include "Socket.h"
+#include "../Source/Body.h"
+
+#include "ofPixels.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Receives frames from a Server. Used by Device::openRemote, which feeds the frames into its sources
+		// so that a remote sensor looks like a local one. Only the latest frame of each type is kept.
+		class Client {
+		public:
+			Client();
+			~Client();
+
+			bool connect(const string & host, int port = DefaultPort);
+			void close();
+			bool isConnected() const;
+
+			// Ask the server for these SourceFlags only
+			void subscribe(int sourceFlags);
+			// Ask the server for the types of these sources
+			void subscribe(const vector<shared_ptr<Source::Base>> &);
+
+			// Loads the latest received frames into the matching sources, sources without a new frame are marked as not new
+			void update(const vector<shared_ptr<Source::Base>> &);
+
+			uint64_t getReceivedMessageCount() const;
+		protected:
+			typedef shared_ptr<vector<uint8_t>> Payload;
+
+			void receiveLoop();
+
+			template<typename SourceType, typename PixelType>
+			void loadImage(SourceType &, const Payload &, ofPixels_<PixelType> &);
+
+			Socket socket;
+			std::thread receiveThread;
+			std::atomic<bool> running;
+			std::atomic<bool> connected;
+			std::atomic<uint64_t> receivedMessageCount;
+
+			std::mutex sendMutex;
+			std::mutex latestMutex;
+			Payload latest[MessageType_Count];
+
+			ofShortPixels shortPixels;
+			ofPixels pixels;
+			Source::Body::RawFrame rawBodyFrame;
+		};
+	}
+}
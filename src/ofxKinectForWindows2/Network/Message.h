@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Wire format shared by Server and Client. Every message is a MessageHeader followed by size bytes of payload.
+		// Image payloads are an ImageHeader followed by the pixels, Body payloads are a Source::Body::RawFrame.
+		// Values are in the host byte order (both ends are Windows machines).
+		enum {
+			DefaultPort = 8765,
+			MessageMagic = 0x3257464B, // "KFW2"
+			MaxMessageSize = 64 * 1024 * 1024
+		};
+
+		enum MessageType {
+			MessageType_Subscribe = 0, // client to server, payload is a uint32_t of SourceFlags
+			MessageType_Depth,
+			MessageType_Color,
+			MessageType_Infrared,
+			MessageType_LongExposureInfrared,
+			MessageType_BodyIndex,
+			MessageType_Body,
+			MessageType_Count
+		};
+
+		enum SourceFlags {
+			SourceFlags_Depth = 1 << MessageType_Depth,
+			SourceFlags_Color = 1 << MessageType_Color,
+			SourceFlags_Infrared = 1 << MessageType_Infrared,
+			SourceFlags_LongExposureInfrared = 1 << MessageType_LongExposureInfrared,
+			SourceFlags_BodyIndex = 1 << MessageType_BodyIndex,
+			SourceFlags_Body = 1 << MessageType_Body,
+			SourceFlags_All = SourceFlags_Depth | SourceFlags_Color | SourceFlags_Infrared | SourceFlags_LongExposureInfrared | SourceFlags_BodyIndex | SourceFlags_Body
+		};
+
+		struct MessageHeader {
+			uint32_t magic;
+			uint16_t type;
+			uint16_t reserved;
+			uint32_t size;
+		};
+
+		struct ImageHeader {
+			uint16_t width;
+			uint16_t height;
+			uint8_t channels;
+			uint8_t bytesPerChannel;
+			uint16_t reserved;
+			int64_t relativeTime; // sensor time of the frame on the server (100ns ticks)
+		};
+	}
+}
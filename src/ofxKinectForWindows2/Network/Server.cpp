@@ -0,0 +1,327 @@
+#include "Server.h"
+#include "../Device.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		Server::Server() {
+			this->running = false;
+			this->sources = SourceFlags_All;
+			this->colorDownscale = 4;
+			this->queueLength = 4;
+			this->droppedMessageCount = 0;
+		}
+
+		//----------
+		Server::~Server() {
+			this->close();
+		}
+
+		//----------
+		bool Server::open(int port) {
+			this->close();
+			if (!this->listener.listen(port)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Failed to listen on port " << port;
+				return false;
+			}
+			this->running = true;
+			this->acceptThread = std::thread([this]() {
+				this->acceptLoop();
+			});
+			return true;
+		}
+
+		//----------
+		void Server::close() {
+			if (!this->running) {
+				return;
+			}
+			this->running = false;
+			if (this->acceptThread.joinable()) {
+				this->acceptThread.join();
+			}
+			this->listener.close();
+
+			std::lock_guard<std::mutex> lock(this->connectionsMutex);
+			for (auto & connection : this->connections) {
+				connection->running = false;
+				connection->socket->shutdown();
+				connection->wake.notify_all();
+			}
+			for (auto & connection : this->connections) {
+				connection->thread.join();
+			}
+			this->connections.clear();
+		}
+
+		//----------
+		bool Server::isOpen() const {
+			return this->running;
+		}
+
+		//----------
+		void Server::setSources(int sourceFlags) {
+			this->sources = sourceFlags & SourceFlags_All;
+		}
+
+		//----------
+		int Server::getSources() const {
+			return this->sources;
+		}
+
+		//----------
+		void Server::setColorDownscale(int colorDownscale) {
+			this->colorDownscale = std::max(colorDownscale, 1);
+		}
+
+		//----------
+		int Server::getColorDownscale() const {
+			return this->colorDownscale;
+		}
+
+		//----------
+		void Server::setQueueLength(int queueLength) {
+			this->queueLength = std::max(queueLength, 1);
+		}
+
+		//----------
+		int Server::getQueueLength() const {
+			return this->queueLength;
+		}
+
+		//----------
+		void Server::publish(const Device & device) {
+			this->removeClosedConnections();
+
+			//only prepare what somebody is listening to
+			int wanted = 0;
+			{
+				std::lock_guard<std::mutex> lock(this->connectionsMutex);
+				for (auto & connection : this->connections) {
+					wanted |= connection->subscription;
+				}
+			}
+			wanted &= this->sources;
+			if (!wanted) {
+				return;
+			}
+
+			auto depth = device.getDepthSource();
+			if (depth && depth->isFrameNew() && (wanted & SourceFlags_Depth)) {
+				this->publishImage(MessageType_Depth, depth->getPixels(), depth->getRelativeTime());
+			}
+
+			auto color = device.getColorSource();
+			if (color && color->isFrameNew() && (wanted & SourceFlags_Color) && color->getPixels().isAllocated()) {
+				const auto & pixels = color->getPixels();
+				const int factor = this->colorDownscale;
+				if (factor == 1) {
+					this->publishImage(MessageType_Color, pixels, color->getRelativeTime());
+				}
+				else {
+					//box filter, each output pixel is the mean of factor x factor input pixels
+					const int width = pixels.getWidth() / factor;
+					const int height = pixels.getHeight() / factor;
+					const int channels = pixels.getNumChannels();
+					if (this->downscaledColor.getWidth() != width || this->downscaledColor.getHeight() != height || this->downscaledColor.getNumChannels() != channels) {
+						this->downscaledColor.allocate(width, height, channels);
+					}
+					const unsigned char * in = pixels.getData();
+					unsigned char * out = this->downscaledColor.getData();
+					const size_t inputStride = pixels.getWidth() * channels;
+					const int area = factor * factor;
+					unsigned int sum[4];
+					for (int y = 0; y < height; y++) {
+						for (int x = 0; x < width; x++) {
+							memset(sum, 0, sizeof(sum));
+							const unsigned char * block = in + (y * factor) * inputStride + (x * factor) * channels;
+							for (int j = 0; j < factor; j++) {
+								const unsigned char * row = block + j * inputStride;
+								for (int i = 0; i < factor * channels; i += channels) {
+									for (int c = 0; c < channels && c < 4; c++) {
+										sum[c] += row[i + c];
+									}
+								}
+							}
+							for (int c = 0; c < channels && c < 4; c++) {
+								*out++ = (unsigned char) (sum[c] / area);
+							}
+						}
+					}
+					this->publishImage(MessageType_Color, this->downscaledColor, color->getRelativeTime());
+				}
+			}
+
+			auto infrared = device.getInfraredSource();
+			if (infrared && infrared->isFrameNew() && (wanted & SourceFlags_Infrared)) {
+				this->publishImage(MessageType_Infrared, infrared->getPixels(), infrared->getRelativeTime());
+			}
+
+			auto longExposureInfrared = device.getLongExposureInfraredSource();
+			if (longExposureInfrared && longExposureInfrared->isFrameNew() && (wanted & SourceFlags_LongExposureInfrared)) {
+				this->publishImage(MessageType_LongExposureInfrared, longExposureInfrared->getPixels(), longExposureInfrared->getRelativeTime());
+			}
+
+			auto bodyIndex = device.getBodyIndexSource();
+			if (bodyIndex && bodyIndex->isFrameNew() && (wanted & SourceFlags_BodyIndex)) {
+				this->publishImage(MessageType_BodyIndex, bodyIndex->getPixels(), bodyIndex->getRelativeTime());
+			}
+
+			auto body = device.getBodySource();
+			if (body && body->isFrameNew() && (wanted & SourceFlags_Body)) {
+				body->getRawFrame(this->rawBodyFrame);
+				this->publish(MessageType_Body, nullptr, 0, &this->rawBodyFrame, sizeof(this->rawBodyFrame));
+			}
+		}
+
+		//----------
+		int Server::getClientCount() {
+			this->removeClosedConnections();
+			std::lock_guard<std::mutex> lock(this->connectionsMutex);
+			return (int) this->connections.size();
+		}
+
+		//----------
+		uint64_t Server::getDroppedMessageCount() const {
+			return this->droppedMessageCount;
+		}
+
+		//----------
+		void Server::acceptLoop() {
+			while (this->running) {
+				if (!this->listener.waitReadable(100)) {
+					continue;
+				}
+				auto socket = this->listener.accept();
+				if (!socket) {
+					continue;
+				}
+
+				auto connection = make_shared<Connection>();
+				connection->socket = std::move(socket);
+				connection->subscription = SourceFlags_All; // until the client tells us otherwise
+				connection->running = true;
+
+				std::lock_guard<std::mutex> lock(this->connectionsMutex);
+				if (!this->running) {
+					break;
+				}
+				auto rawConnection = connection.get();
+				connection->thread = std::thread([this, rawConnection]() {
+					this->connectionLoop(rawConnection);
+				});
+				this->connections.push_back(connection);
+			}
+		}
+
+		//----------
+		void Server::connectionLoop(Connection * connection) {
+			auto & socket = *connection->socket;
+			while (connection->running) {
+				MessagePtr message;
+				{
+					std::unique_lock<std::mutex> lock(connection->mutex);
+					connection->wake.wait_for(lock, std::chrono::milliseconds(10), [connection]() {
+						return !connection->queue.empty() || !connection->running;
+					});
+					if (!connection->queue.empty()) {
+						message = connection->queue.front();
+						connection->queue.pop_front();
+					}
+				}
+				if (message && !socket.sendAll(message->data(), message->size())) {
+					break;
+				}
+
+				//subscription changes from the client
+				bool failed = false;
+				while (socket.waitReadable(0)) {
+					MessageHeader header;
+					if (!socket.receiveAll(&header, sizeof(header)) || header.magic != MessageMagic || header.size > 1024) {
+						failed = true;
+						break;
+					}
+					vector<uint8_t> payload(header.size);
+					if (header.size > 0 && !socket.receiveAll(payload.data(), payload.size())) {
+						failed = true;
+						break;
+					}
+					if (header.type == MessageType_Subscribe && header.size == sizeof(uint32_t)) {
+						uint32_t subscription;
+						memcpy(&subscription, payload.data(), sizeof(subscription));
+						connection->subscription = (int) subscription;
+					}
+				}
+				if (failed) {
+					break;
+				}
+			}
+			connection->running = false;
+		}
+
+		//----------
+		void Server::removeClosedConnections() {
+			std::lock_guard<std::mutex> lock(this->connectionsMutex);
+			for (auto it = this->connections.begin(); it != this->connections.end(); ) {
+				if (!(*it)->running) {
+					(*it)->thread.join();
+					it = this->connections.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+
+		//----------
+		template<typename PixelType>
+		void Server::publishImage(MessageType type, const ofPixels_<PixelType> & pixels, INT64 relativeTime) {
+			if (!pixels.isAllocated()) {
+				return;
+			}
+			ImageHeader imageHeader;
+			imageHeader.width = (uint16_t) pixels.getWidth();
+			imageHeader.height = (uint16_t) pixels.getHeight();
+			imageHeader.channels = (uint8_t) pixels.getNumChannels();
+			imageHeader.bytesPerChannel = (uint8_t) sizeof(PixelType);
+			imageHeader.reserved = 0;
+			imageHeader.relativeTime = relativeTime;
+			this->publish(type, &imageHeader, sizeof(imageHeader), pixels.getData(), pixels.getTotalBytes());
+		}
+
+		//----------
+		void Server::publish(MessageType type, const void * header, size_t headerSize, const void * data, size_t size) {
+			//one copy of the message, shared by all the client queues
+			auto message = make_shared<vector<uint8_t>>(sizeof(MessageHeader) + headerSize + size);
+			MessageHeader messageHeader;
+			messageHeader.magic = MessageMagic;
+			messageHeader.type = (uint16_t) type;
+			messageHeader.reserved = 0;
+			messageHeader.size = (uint32_t) (headerSize + size);
+			memcpy(message->data(), &messageHeader, sizeof(messageHeader));
+			if (headerSize > 0) {
+				memcpy(message->data() + sizeof(messageHeader), header, headerSize);
+			}
+			memcpy(message->data() + sizeof(messageHeader) + headerSize, data, size);
+			MessagePtr sharedMessage = message;
+
+			const size_t queueLength = this->queueLength;
+			std::lock_guard<std::mutex> lock(this->connectionsMutex);
+			for (auto & connection : this->connections) {
+				if (!connection->running || !(connection->subscription & (1 << type))) {
+					continue;
+				}
+				{
+					std::lock_guard<std::mutex> queueLock(connection->mutex);
+					while (connection->queue.size() >= queueLength) {
+						connection->queue.pop_front();
+						this->droppedMessageCount++;
+					}
+					connection->queue.push_back(sharedMessage);
+				}
+				connection->wake.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Message.h"
+#include "Socket.h"
+#include "../Source/Body.h"
+
+#include "ofPixels.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ofxKinectForWindows2 {
+	class Device;
+
+	namespace Network {
+		// Serves the frames of a local Device to other machines over TCP (see Client and Device::openRemote).
+		// Each client gets its own send queue and thread. When a client falls behind, the oldest queued
+		// frames are dropped so it always receives recent data and never slows the others down.
+		class Server {
+		public:
+			Server();
+			~Server();
+
+			bool open(int port = DefaultPort);
+			void close();
+			bool isOpen() const;
+
+			// SourceFlags which may be published (default all). Clients receive the ones they subscribe to.
+			void setSources(int sourceFlags);
+			int getSources() const;
+
+			// Colour frames are shrunk by this factor before sending (default 4, i.e. 480x270)
+			void setColorDownscale(int);
+			int getColorDownscale() const;
+
+			// Messages waiting per client before the oldest are dropped (default 4)
+			void setQueueLength(int);
+			int getQueueLength() const;
+
+			// Call after Device::update() to send the new frames
+			void publish(const Device &);
+
+			int getClientCount();
+			uint64_t getDroppedMessageCount() const;
+		protected:
+			typedef shared_ptr<const vector<uint8_t>> MessagePtr;
+
+			struct Connection {
+				unique_ptr<Socket> socket;
+				std::thread thread;
+				std::mutex mutex;
+				std::condition_variable wake;
+				std::deque<MessagePtr> queue;
+				std::atomic<int> subscription;
+				std::atomic<bool> running;
+			};
+
+			void acceptLoop();
+			void connectionLoop(Connection *);
+			void removeClosedConnections();
+
+			template<typename PixelType>
+			void publishImage(MessageType, const ofPixels_<PixelType> &, INT64 relativeTime);
+			void publish(MessageType, const void * header, size_t headerSize, const void * data, size_t size);
+
+			Socket listener;
+			std::thread acceptThread;
+			std::atomic<bool> running;
+
+			std::mutex connectionsMutex;
+			vector<shared_ptr<Connection>> connections;
+
+			int sources;
+			int colorDownscale;
+			std::atomic<int> queueLength;
+			std::atomic<uint64_t> droppedMessageCount;
+
+			ofPixels downscaledColor;
+			Source::Body::RawFrame rawBodyFrame;
+		};
+	}
+}
@@ -0,0 +1,253 @@
+#include "Socket.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#define INVALID_HANDLE ((Handle) INVALID_SOCKET)
+#define closeHandle closesocket
+#define SHUTDOWN_BOTH SD_BOTH
+typedef int socklen_t;
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#define INVALID_HANDLE ((Handle) -1)
+#define closeHandle ::close
+#define SHUTDOWN_BOTH SHUT_RDWR
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		//----------
+		static void initSockets() {
+#ifdef _WIN32
+			static std::atomic<bool> initialised(false);
+			if (!initialised.exchange(true)) {
+				WSADATA data;
+				WSAStartup(MAKEWORD(2, 2), &data);
+			}
+#endif
+		}
+
+		//----------
+		Socket::Socket() {
+			initSockets();
+			this->handle = INVALID_HANDLE;
+		}
+
+		//----------
+		Socket::Socket(Handle handle) {
+			this->handle = handle;
+		}
+
+		//----------
+		Socket::~Socket() {
+			this->close();
+		}
+
+		//----------
+		bool Socket::listen(int port) {
+			this->close();
+			this->handle = (Handle) ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			if (this->handle == INVALID_HANDLE) {
+				return false;
+			}
+			int reuse = 1;
+			setsockopt(this->handle, SOL_SOCKET, SO_REUSEADDR, (const char *) &reuse, sizeof(reuse));
+
+			sockaddr_in address;
+			memset(&address, 0, sizeof(address));
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_ANY);
+			address.sin_port = htons((uint16_t) port);
+			if (::bind(this->handle, (sockaddr *) &address, sizeof(address)) != 0 || ::listen(this->handle, 8) != 0) {
+				this->close();
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		std::unique_ptr<Socket> Socket::accept() {
+			if (!this->isOpen()) {
+				return nullptr;
+			}
+			Handle client = (Handle) ::accept(this->handle, nullptr, nullptr);
+			if (client == INVALID_HANDLE) {
+				return nullptr;
+			}
+			int noDelay = 1;
+			setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char *) &noDelay, sizeof(noDelay));
+			return std::unique_ptr<Socket>(new Socket(client));
+		}
+
+		//----------
+		bool Socket::connect(const std::string & host, int port) {
+			this->close();
+
+			addrinfo hints;
+			memset(&hints, 0, sizeof(hints));
+			hints.ai_family = AF_INET;
+			hints.ai_socktype = SOCK_STREAM;
+			hints.ai_protocol = IPPROTO_TCP;
+			addrinfo * results = nullptr;
+			if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0) {
+				return false;
+			}
+			for (auto result = results; result; result = result->ai_next) {
+				this->handle = (Handle) ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+				if (this->handle == INVALID_HANDLE) {
+					continue;
+				}
+				if (::connect(this->handle, result->ai_addr, (socklen_t) result->ai_addrlen) == 0) {
+					break;
+				}
+				this->close();
+			}
+			freeaddrinfo(results);
+			if (!this->isOpen()) {
+				return false;
+			}
+
+			int noDelay = 1;
+			setsockopt(this->handle, IPPROTO_TCP, TCP_NODELAY, (const char *) &noDelay, sizeof(noDelay));
+			return true;
+		}
+
+		//----------
+		bool Socket::openDatagram(const std::string & host, int port) {
+			this->close();
+
+			addrinfo hints;
+			memset(&hints, 0, sizeof(hints));
+			hints.ai_family = AF_INET;
+			hints.ai_socktype = SOCK_DGRAM;
+			hints.ai_protocol = IPPROTO_UDP;
+			addrinfo * results = nullptr;
+			if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0) {
+				return false;
+			}
+			this->handle = (Handle) ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			if (this->handle != INVALID_HANDLE) {
+				int broadcast = 1;
+				setsockopt(this->handle, SOL_SOCKET, SO_BROADCAST, (const char *) &broadcast, sizeof(broadcast));
+				if (::connect(this->handle, results->ai_addr, (socklen_t) results->ai_addrlen) != 0) {
+					this->close();
+				}
+			}
+			freeaddrinfo(results);
+			return this->isOpen();
+		}
+
+		//----------
+		bool Socket::bindDatagram(int port) {
+			this->close();
+			this->handle = (Handle) ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			if (this->handle == INVALID_HANDLE) {
+				return false;
+			}
+			int reuse = 1;
+			setsockopt(this->handle, SOL_SOCKET, SO_REUSEADDR, (const char *) &reuse, sizeof(reuse));
+
+			sockaddr_in address;
+			memset(&address, 0, sizeof(address));
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_ANY);
+			address.sin_port = htons((uint16_t) port);
+			if (::bind(this->handle, (sockaddr *) &address, sizeof(address)) != 0) {
+				this->close();
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		bool Socket::sendDatagram(const void * data, size_t size) {
+			return ::send(this->handle, (const char *) data, (int) size, 0) == (int) size;
+		}
+
+		//----------
+		int Socket::receiveDatagram(void * data, size_t size) {
+			return (int) ::recv(this->handle, (char *) data, (int) size, 0);
+		}
+
+		//----------
+		bool Socket::sendAll(const void * data, size_t size) {
+			auto bytes = (const char *) data;
+			while (size > 0) {
+#ifdef _WIN32
+				int sent = ::send(this->handle, bytes, (int) std::min<size_t>(size, 1 << 30), 0);
+#else
+				auto sent = ::send(this->handle, bytes, size, MSG_NOSIGNAL);
+#endif
+				if (sent <= 0) {
+					return false;
+				}
+				bytes += sent;
+				size -= sent;
+			}
+			return true;
+		}
+
+		//----------
+		bool Socket::receiveAll(void * data, size_t size) {
+			auto bytes = (char *) data;
+			while (size > 0) {
+#ifdef _WIN32
+				int received = ::recv(this->handle, bytes, (int) std::min<size_t>(size, 1 << 30), 0);
+#else
+				auto received = ::recv(this->handle, bytes, size, 0);
+#endif
+				if (received <= 0) {
+					return false;
+				}
+				bytes += received;
+				size -= received;
+			}
+			return true;
+		}
+
+		//----------
+		bool Socket::waitReadable(int timeoutMilliseconds) {
+			if (!this->isOpen()) {
+				return false;
+			}
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(this->handle, &readSet);
+			timeval timeout;
+			timeout.tv_sec = timeoutMilliseconds / 1000;
+			timeout.tv_usec = (timeoutMilliseconds % 1000) * 1000;
+			return ::select((int) this->handle + 1, &readSet, nullptr, nullptr, &timeout) > 0;
+		}
+
+		//----------
+		void Socket::shutdown() {
+			if (this->handle != INVALID_HANDLE) {
+				::shutdown(this->handle, SHUTDOWN_BOTH);
+			}
+		}
+
+		//----------
+		void Socket::close() {
+			if (this->handle != INVALID_HANDLE) {
+				::shutdown(this->handle, SHUTDOWN_BOTH);
+				closeHandle(this->handle);
+				this->handle = INVALID_HANDLE;
+			}
+		}
+
+		//----------
+		bool Socket::isOpen() const {
+			return this->handle != INVALID_HANDLE;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+namespace ofxKinectForWindows2 {
+	namespace Network {
+		// Minimal blocking TCP socket used by Server and Client, or UDP socket used by BodyBroadcaster and BodyReceiver.
+		// Calls may come from different threads, but only one thread sends and one thread receives at a time.
+		class Socket {
+		public:
+#ifdef _WIN32
+			typedef uintptr_t Handle;
+#else
+			typedef int Handle;
+#endif
+			Socket();
+			~Socket();
+
+			bool listen(int port);
+			// Blocks until a client connects (use waitReadable to poll)
+			std::unique_ptr<Socket> accept();
+			bool connect(const std::string & host, int port);
+
+			// UDP : datagrams to host:port (broadcast addresses allowed)
+			bool openDatagram(const std::string & host, int port);
+			// UDP : datagrams sent to this port from anywhere
+			bool bindDatagram(int port);
+			bool sendDatagram(const void * data, size_t size);
+			// Size of the datagram received, or -1
+			int receiveDatagram(void * data, size_t size);
+
+			bool sendAll(const void * data, size_t size);
+			bool receiveAll(void * data, size_t size);
+			// Waits up to timeout for data to read
+			bool waitReadable(int timeoutMilliseconds);
+
+			// Makes sends and receives in other threads fail, so they can be joined before close()
+			void shutdown();
+			void close();
+			bool isOpen() const;
+		protected:
+			Socket(Handle);
+			Socket(const Socket &) = delete;
+			Socket & operator=(const Socket &) = delete;
+
+			Handle handle;
+		};
+	}
+}
@@ -0,0 +1,312 @@
+#include "BodyContours.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Cell corners are the pixels TL (8), TR (4), BR (2), BL (1).
+		// Edges are top (0), right (1), bottom (2), left (3).
+		// For each case, the edge through which a contour leaves the cell given the edge it entered by (-1 if none).
+		// Saddles (5 and 10) keep diagonal pixels apart.
+		static const signed char exitEdges[16][4] = {
+			{ -1, -1, -1, -1 },
+			{ -1, -1, -1, 2 },
+			{ -1, -1, 1, -1 },
+			{ -1, -1, -1, 1 },
+			{ -1, 0, -1, -1 },
+			{ -1, 0, -1, 2 },
+			{ -1, -1, 0, -1 },
+			{ -1, -1, -1, 0 },
+			{ 3, -1, -1, -1 },
+			{ 2, -1, -1, -1 },
+			{ 3, -1, 1, -1 },
+			{ 1, -1, -1, -1 },
+			{ -1, 3, -1, -1 },
+			{ -1, 2, -1, -1 },
+			{ -1, -1, 3, -1 },
+			{ -1, -1, -1, -1 }
+		};
+		static const int edgeOffsetX[4] = { 0, 1, 0, -1 };
+		static const int edgeOffsetY[4] = { -1, 0, 1, 0 };
+		static const int oppositeEdge[4] = { 2, 3, 0, 1 };
+		// Where the iso line crosses each edge, relative to the cell's BR pixel
+		static const float edgePointX[4] = { -0.5f, 0.0f, -0.5f, -1.0f };
+		static const float edgePointY[4] = { -1.0f, -0.5f, 0.0f, -0.5f };
+
+		//----------
+		BodyContours::BodyContours() {
+			this->tolerance = 1.0f;
+			this->minimumArea = 16.0f;
+			this->findHoles = true;
+			this->lastUpdateDuration = 0.0f;
+		}
+
+		//----------
+		void BodyContours::setTolerance(float tolerance) {
+			this->tolerance = std::max(tolerance, 0.0f);
+		}
+
+		//----------
+		float BodyContours::getTolerance() const {
+			return this->tolerance;
+		}
+
+		//----------
+		void BodyContours::setMinimumArea(float minimumArea) {
+			this->minimumArea = minimumArea;
+		}
+
+		//----------
+		float BodyContours::getMinimumArea() const {
+			return this->minimumArea;
+		}
+
+		//----------
+		void BodyContours::setFindHoles(bool findHoles) {
+			this->findHoles = findHoles;
+		}
+
+		//----------
+		bool BodyContours::getFindHoles() const {
+			return this->findHoles;
+		}
+
+		//----------
+		bool BodyContours::update(const Source::BodyIndex & bodyIndex) {
+			return this->update(bodyIndex.getPixels());
+		}
+
+		//----------
+		bool BodyContours::update(const ofPixels & bodyIndex) {
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			for (int b = 0; b < BODY_COUNT; b++) {
+				this->contours[b].clear();
+				this->points[b].clear();
+			}
+			if (!bodyIndex.isAllocated()) {
+				return false;
+			}
+
+			const int width = (int) bodyIndex.getWidth();
+			const int height = (int) bodyIndex.getHeight();
+			const unsigned char * data = bodyIndex.getData();
+
+			//bounds of every body, so we only march the cells around each one
+			int minX[BODY_COUNT], minY[BODY_COUNT], maxX[BODY_COUNT], maxY[BODY_COUNT];
+			for (int b = 0; b < BODY_COUNT; b++) {
+				minX[b] = minY[b] = std::numeric_limits<int>::max();
+				maxX[b] = maxY[b] = -1;
+			}
+			for (int y = 0; y < height; y++) {
+				const unsigned char * row = data + y * width;
+				for (int x = 0; x < width; x++) {
+					//skip runs of background 8 pixels at a time
+					if (x + 8 <= width) {
+						uint64_t block;
+						memcpy(&block, row + x, sizeof(block));
+						if (block == ~(uint64_t) 0) {
+							x += 7;
+							continue;
+						}
+					}
+					const unsigned char index = row[x];
+					if (index < BODY_COUNT) {
+						minX[index] = std::min(minX[index], x);
+						maxX[index] = std::max(maxX[index], x);
+						minY[index] = std::min(minY[index], y);
+						maxY[index] = y;
+					}
+				}
+			}
+
+			for (int b = 0; b < BODY_COUNT; b++) {
+				if (maxX[b] >= 0) {
+					this->trace(data, width, height, b, minX[b], minY[b], maxX[b], maxY[b]);
+				}
+			}
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			this->lastUpdateDuration = std::chrono::duration<float, std::micro>(endTime - startTime).count();
+			return true;
+		}
+
+		//----------
+		const vector<BodyContours::Contour> & BodyContours::getContours(int bodyIndex) const {
+			return this->contours[bodyIndex];
+		}
+
+		//----------
+		const vector<ofVec2f> & BodyContours::getPoints(int bodyIndex) const {
+			return this->points[bodyIndex];
+		}
+
+		//----------
+		void BodyContours::getPolyline(int bodyIndex, int contourIndex, ofPolyline & polyline) const {
+			const auto & contour = this->contours[bodyIndex].at(contourIndex);
+			const auto & points = this->points[bodyIndex];
+			polyline.clear();
+			for (int i = contour.begin; i < contour.begin + contour.count; i++) {
+				polyline.addVertex(points[i].x, points[i].y);
+			}
+			polyline.close();
+		}
+
+		//----------
+		float BodyContours::getLastUpdateDuration() const {
+			return this->lastUpdateDuration;
+		}
+
+		//----------
+		void BodyContours::trace(const unsigned char * bodyIndex, int width, int height, int body, int minX, int minY, int maxX, int maxY) {
+			//cell (cx, cy) has the pixel (cx, cy) as its BR corner, so cells around the body span [min, max + 1]
+			const int cellsX = maxX - minX + 2;
+			const int cellsY = maxY - minY + 2;
+			const unsigned char value = (unsigned char) body;
+
+			auto inside = [&](int x, int y) {
+				return x >= 0 && y >= 0 && x < width && y < height && bodyIndex[y * width + x] == value;
+			};
+
+			this->cases.resize(cellsX * cellsY);
+			this->visited.assign(cellsX * cellsY, 0);
+			for (int j = 0; j < cellsY; j++) {
+				const int cy = minY + j;
+				bool topLeft = inside(minX - 1, cy - 1);
+				bool bottomLeft = inside(minX - 1, cy);
+				for (int i = 0; i < cellsX; i++) {
+					const int cx = minX + i;
+					bool topRight = inside(cx, cy - 1);
+					bool bottomRight = inside(cx, cy);
+					this->cases[j * cellsX + i] = (topLeft ? 8 : 0) | (topRight ? 4 : 0) | (bottomRight ? 2 : 0) | (bottomLeft ? 1 : 0);
+					topLeft = topRight;
+					bottomLeft = bottomRight;
+				}
+			}
+
+			for (int j = 0; j < cellsY; j++) {
+				for (int i = 0; i < cellsX; i++) {
+					const int startCase = this->cases[j * cellsX + i];
+					if (startCase == 0 || startCase == 15) {
+						continue;
+					}
+					for (int startEdge = 0; startEdge < 4; startEdge++) {
+						if (exitEdges[startCase][startEdge] == -1 || (this->visited[j * cellsX + i] & (1 << startEdge))) {
+							continue;
+						}
+
+						//follow the contour until we're back where we started
+						this->tracePoints.clear();
+						int x = i, y = j, edge = startEdge;
+						float area = 0.0f;
+						while (!(this->visited[y * cellsX + x] & (1 << edge))) {
+							this->visited[y * cellsX + x] |= 1 << edge;
+							const int exitEdge = exitEdges[this->cases[y * cellsX + x]][edge];
+							this->tracePoints.emplace_back(minX + x + edgePointX[exitEdge], minY + y + edgePointY[exitEdge]);
+							x += edgeOffsetX[exitEdge];
+							y += edgeOffsetY[exitEdge];
+							edge = oppositeEdge[exitEdge];
+						}
+
+						//shoelace area : positive for outlines (body on the right), negative for holes
+						const int count = (int) this->tracePoints.size();
+						for (int p = 0; p < count; p++) {
+							const auto & a = this->tracePoints[p];
+							const auto & b = this->tracePoints[(p + 1) % count];
+							area += a.x * b.y - b.x * a.y;
+						}
+						area *= 0.5f;
+
+						if (std::abs(area) < this->minimumArea || (area < 0.0f && !this->findHoles)) {
+							continue;
+						}
+						this->simplify(body, area);
+					}
+				}
+			}
+		}
+
+		//----------
+		void BodyContours::simplify(int body, float area) {
+			const auto & input = this->tracePoints;
+			const int count = (int) input.size();
+			auto & output = this->points[body];
+
+			Contour contour;
+			contour.begin = (int) output.size();
+			contour.hole = area < 0.0f;
+			contour.area = area;
+
+			if (this->tolerance <= 0.0f || count < 4) {
+				output.insert(output.end(), input.begin(), input.end());
+				contour.count = count;
+				this->contours[body].push_back(contour);
+				return;
+			}
+
+			//closed Douglas-Peucker : split at the point furthest from the first, then simplify both halves
+			this->keep.assign(count, 0);
+			int furthest = 0;
+			float furthestDistance = -1.0f;
+			for (int i = 1; i < count; i++) {
+				float distance = (input[i] - input[0]).lengthSquared();
+				if (distance > furthestDistance) {
+					furthestDistance = distance;
+					furthest = i;
+				}
+			}
+			this->keep[0] = 1;
+			this->keep[furthest] = 1;
+
+			const float toleranceSquared = this->tolerance * this->tolerance;
+			this->stack.clear();
+			this->stack.emplace_back(0, furthest);
+			this->stack.emplace_back(furthest, count); // count wraps to point 0
+			while (!this->stack.empty()) {
+				const auto range = this->stack.back();
+				this->stack.pop_back();
+				if (range.second - range.first < 2) {
+					continue;
+				}
+
+				const ofVec2f & a = input[range.first];
+				const ofVec2f & b = input[range.second % count];
+				const ofVec2f ab = b - a;
+				const float abLengthSquared = ab.lengthSquared();
+
+				int split = -1;
+				float splitDistance = toleranceSquared;
+				for (int i = range.first + 1; i < range.second; i++) {
+					const ofVec2f ap = input[i] - a;
+					float distance;
+					if (abLengthSquared > 0.0f) {
+						float cross = ab.x * ap.y - ab.y * ap.x;
+						distance = cross * cross / abLengthSquared;
+					}
+					else {
+						distance = ap.lengthSquared();
+					}
+					if (distance > splitDistance) {
+						splitDistance = distance;
+						split = i;
+					}
+				}
+
+				if (split != -1) {
+					this->keep[split] = 1;
+					this->stack.emplace_back(range.first, split);
+					this->stack.emplace_back(split, range.second);
+				}
+			}
+
+			for (int i = 0; i < count; i++) {
+				if (this->keep[i]) {
+					output.push_back(input[i]);
+				}
+			}
+			contour.count = (int) output.size() - contour.begin;
+			this->contours[body].push_back(contour);
+		}
+	}
+}
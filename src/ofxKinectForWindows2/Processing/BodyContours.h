@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Source/BodyIndex.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Traces the outline of every body in the BodyIndex image with marching squares.
+		// Outline points sit on the iso line between body and background pixels (half pixel precision),
+		// and are ordered with the body on the right, so outer contours have positive area and holes
+		// negative area. Contours are then simplified with Douglas-Peucker.
+		// Points of all contours of a body are stored in one reusable buffer.
+		class BodyContours {
+		public:
+			struct Contour {
+				int begin; // first point in getPoints(body)
+				int count;
+				bool hole;
+				float area; // pixels, negative for holes
+			};
+
+			BodyContours();
+
+			// Maximum distance in pixels between the simplified and traced outline (0 keeps every point)
+			void setTolerance(float);
+			float getTolerance() const;
+
+			// Contours enclosing less than this many pixels are dropped
+			void setMinimumArea(float);
+			float getMinimumArea() const;
+
+			void setFindHoles(bool);
+			bool getFindHoles() const;
+
+			bool update(const Source::BodyIndex &);
+			bool update(const ofPixels & bodyIndex);
+
+			const vector<Contour> & getContours(int bodyIndex) const;
+			const vector<ofVec2f> & getPoints(int bodyIndex) const;
+			void getPolyline(int bodyIndex, int contourIndex, ofPolyline &) const;
+
+			// Duration of the last call to update() in microseconds
+			float getLastUpdateDuration() const;
+		protected:
+			void trace(const unsigned char * bodyIndex, int width, int height, int body, int minX, int minY, int maxX, int maxY);
+			void simplify(int body, float area);
+
+			float tolerance;
+			float minimumArea;
+			bool findHoles;
+
+			vector<Contour> contours[BODY_COUNT];
+			vector<ofVec2f> points[BODY_COUNT];
+
+			// scratch
+			vector<unsigned char> cases;
+			vector<unsigned char> visited;
+			vector<ofVec2f> tracePoints;
+			vector<unsigned char> keep;
+			vector<std::pair<int, int>> stack;
+
+			float lastUpdateDuration;
+		};
+	}
+}
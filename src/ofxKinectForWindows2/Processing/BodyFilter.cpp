@@ -0,0 +1,304 @@
+#include "BodyFilter.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+#pragma mark Kernels
+		//----------
+		// Smoothing factor for a first order low pass at the given cutoff (Hz)
+		static inline float lowPassAlpha(float cutoff, float dt) {
+			return 1.0f / (1.0f + 1.0f / (TWO_PI * cutoff * dt));
+		}
+
+		//----------
+		static void oneEuroKernel(const float * input, float * output, float * previous, float * derivative
+			, const float * minCutoff, const float * beta, const float * derivativeCutoff
+			, float dt, int count) {
+			const float rate = 1.0f / dt;
+			for (int i = 0; i < count; i++) {
+				const float dx = (input[i] - previous[i]) * rate;
+				const float derivativeAlpha = lowPassAlpha(derivativeCutoff[i], dt);
+				const float filteredDx = derivative[i] + derivativeAlpha * (dx - derivative[i]);
+				const float cutoff = minCutoff[i] + beta[i] * fabsf(filteredDx);
+				const float alpha = lowPassAlpha(cutoff, dt);
+				const float filtered = previous[i] + alpha * (input[i] - previous[i]);
+
+				derivative[i] = filteredDx;
+				previous[i] = filtered;
+				output[i] = filtered;
+			}
+		}
+
+		//----------
+		static void doubleExponentialKernel(const float * input, float * output, float * previous, float * trend
+			, const float * smoothing, const float * correction, const float * prediction
+			, int count) {
+			for (int i = 0; i < count; i++) {
+				const float filtered = input[i] * (1.0f - smoothing[i]) + (previous[i] + trend[i]) * smoothing[i];
+				const float newTrend = (filtered - previous[i]) * correction[i] + trend[i] * (1.0f - correction[i]);
+
+				previous[i] = filtered;
+				trend[i] = newTrend;
+				output[i] = filtered + newTrend * prediction[i];
+			}
+		}
+
+#pragma mark BodyFilter
+		//----------
+		BodyFilter::Settings::Settings() {
+			this->minCutoff = 1.0f;
+			this->beta = 0.5f;
+			this->derivativeCutoff = 1.0f;
+
+			this->smoothing = 0.5f;
+			this->correction = 0.5f;
+			this->prediction = 0.5f;
+			this->jitterRadius = 0.05f;
+			this->maxDeviationRadius = 0.04f;
+		}
+
+		//----------
+		BodyFilter::BodyFilter() {
+			this->mode = None;
+			this->filterOrientations = true;
+			this->lastApplyDuration = 0.0f;
+			this->updateLaneSettings();
+			this->reset();
+		}
+
+		//----------
+		void BodyFilter::setMode(Mode mode) {
+			if (mode != this->mode) {
+				this->mode = mode;
+				this->reset();
+			}
+		}
+
+		//----------
+		BodyFilter::Mode BodyFilter::getMode() const {
+			return this->mode;
+		}
+
+		//----------
+		void BodyFilter::setFilterOrientations(bool filterOrientations) {
+			this->filterOrientations = filterOrientations;
+		}
+
+		//----------
+		bool BodyFilter::getFilterOrientations() const {
+			return this->filterOrientations;
+		}
+
+		//----------
+		void BodyFilter::setSettings(const Settings & settings) {
+			for (auto & jointSettings : this->settings) {
+				jointSettings = settings;
+			}
+			this->updateLaneSettings();
+		}
+
+		//----------
+		void BodyFilter::setSettings(JointType jointType, const Settings & settings) {
+			this->settings[jointType] = settings;
+			this->updateLaneSettings();
+		}
+
+		//----------
+		const BodyFilter::Settings & BodyFilter::getSettings(JointType jointType) const {
+			return this->settings[jointType];
+		}
+
+		//----------
+		void BodyFilter::apply(_Joint * joints, _JointOrientation * jointOrientations, const UINT64 * trackingIds, INT64 relativeTime) {
+			if (this->mode == None) {
+				return;
+			}
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			const int laneJointCount = BODY_COUNT * JointType_Count;
+
+			//gather into lanes
+			for (int i = 0; i < laneJointCount; i++) {
+				const auto & position = joints[i].Position;
+				this->positionInput[i * 3 + 0] = position.X;
+				this->positionInput[i * 3 + 1] = position.Y;
+				this->positionInput[i * 3 + 2] = position.Z;
+
+				//flip quaternions into the same hemisphere as the filtered history
+				const auto & orientation = jointOrientations[i].Orientation;
+				const auto previous = this->orientationPrevious + i * 4;
+				float sign = (orientation.x * previous[0] + orientation.y * previous[1] + orientation.z * previous[2] + orientation.w * previous[3]) < 0.0f ? -1.0f : 1.0f;
+				this->orientationInput[i * 4 + 0] = orientation.x * sign;
+				this->orientationInput[i * 4 + 1] = orientation.y * sign;
+				this->orientationInput[i * 4 + 2] = orientation.z * sign;
+				this->orientationInput[i * 4 + 3] = orientation.w * sign;
+			}
+
+			//reset history of any body which is new, lost or swapped
+			for (int b = 0; b < BODY_COUNT; b++) {
+				if (trackingIds[b] == 0 || trackingIds[b] != this->trackingIds[b]) {
+					this->resetBody(b);
+				}
+				this->trackingIds[b] = trackingIds[b];
+			}
+
+			//filter
+			switch (this->mode) {
+			case OneEuro:
+			{
+				float dt = (float)(relativeTime - this->lastRelativeTime) / 10000000.0f;
+				if (this->lastRelativeTime == 0 || dt <= 0.0f || dt > 1.0f) {
+					dt = 1.0f / 30.0f;
+				}
+
+				oneEuroKernel(this->positionInput, this->positionOutput, this->positionPrevious, this->positionTrend
+					, this->positionMinCutoff, this->positionBeta, this->positionDerivativeCutoff
+					, dt, PositionLaneCount);
+				if (this->filterOrientations) {
+					oneEuroKernel(this->orientationInput, this->orientationOutput, this->orientationPrevious, this->orientationTrend
+						, this->orientationMinCutoff, this->orientationBeta, this->orientationDerivativeCutoff
+						, dt, OrientationLaneCount);
+				}
+				break;
+			}
+			case DoubleExponential:
+			{
+				//jitter removal : pull small movements towards the filtered history
+				for (int i = 0; i < laneJointCount; i++) {
+					const auto & jointSettings = this->settings[i % JointType_Count];
+					auto input = this->positionInput + i * 3;
+					auto previous = this->positionPrevious + i * 3;
+					ofVec3f difference(input[0] - previous[0], input[1] - previous[1], input[2] - previous[2]);
+					float length = difference.length();
+					if (length <= jointSettings.jitterRadius && jointSettings.jitterRadius > 0.0f) {
+						float ratio = length / jointSettings.jitterRadius;
+						for (int c = 0; c < 3; c++) {
+							input[c] = input[c] * ratio + previous[c] * (1.0f - ratio);
+						}
+					}
+				}
+
+				doubleExponentialKernel(this->positionInput, this->positionOutput, this->positionPrevious, this->positionTrend
+					, this->positionSmoothing, this->positionCorrection, this->positionPrediction
+					, PositionLaneCount);
+
+				//clamp prediction to maximum deviation from the raw data
+				for (int i = 0; i < laneJointCount; i++) {
+					const auto & jointSettings = this->settings[i % JointType_Count];
+					const auto & raw = joints[i].Position;
+					auto output = this->positionOutput + i * 3;
+					ofVec3f difference(output[0] - raw.X, output[1] - raw.Y, output[2] - raw.Z);
+					float length = difference.length();
+					if (length > jointSettings.maxDeviationRadius && jointSettings.maxDeviationRadius > 0.0f) {
+						difference *= jointSettings.maxDeviationRadius / length;
+						output[0] = raw.X + difference.x;
+						output[1] = raw.Y + difference.y;
+						output[2] = raw.Z + difference.z;
+					}
+				}
+
+				if (this->filterOrientations) {
+					doubleExponentialKernel(this->orientationInput, this->orientationOutput, this->orientationPrevious, this->orientationTrend
+						, this->orientationSmoothing, this->orientationCorrection, this->orientationPrediction
+						, OrientationLaneCount);
+				}
+				break;
+			}
+			default:
+				break;
+			}
+
+			//scatter back
+			for (int b = 0; b < BODY_COUNT; b++) {
+				if (trackingIds[b] == 0) {
+					continue;
+				}
+				for (int j = 0; j < JointType_Count; j++) {
+					const int i = b * JointType_Count + j;
+
+					auto & position = joints[i].Position;
+					position.X = this->positionOutput[i * 3 + 0];
+					position.Y = this->positionOutput[i * 3 + 1];
+					position.Z = this->positionOutput[i * 3 + 2];
+
+					if (this->filterOrientations) {
+						auto output = this->orientationOutput + i * 4;
+						float length = sqrtf(output[0] * output[0] + output[1] * output[1] + output[2] * output[2] + output[3] * output[3]);
+						if (length > 0.0f) {
+							auto & orientation = jointOrientations[i].Orientation;
+							orientation.x = output[0] / length;
+							orientation.y = output[1] / length;
+							orientation.z = output[2] / length;
+							orientation.w = output[3] / length;
+						}
+					}
+				}
+			}
+
+			this->lastRelativeTime = relativeTime;
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			this->lastApplyDuration = std::chrono::duration<float, std::micro>(endTime - startTime).count();
+		}
+
+		//----------
+		void BodyFilter::reset() {
+			for (int b = 0; b < BODY_COUNT; b++) {
+				this->trackingIds[b] = 0;
+			}
+			memset(this->positionPrevious, 0, sizeof(this->positionPrevious));
+			memset(this->positionTrend, 0, sizeof(this->positionTrend));
+			memset(this->orientationPrevious, 0, sizeof(this->orientationPrevious));
+			memset(this->orientationTrend, 0, sizeof(this->orientationTrend));
+			this->lastRelativeTime = 0;
+		}
+
+		//----------
+		float BodyFilter::getLastApplyDuration() const {
+			return this->lastApplyDuration;
+		}
+
+		//----------
+		void BodyFilter::updateLaneSettings() {
+			for (int b = 0; b < BODY_COUNT; b++) {
+				for (int j = 0; j < JointType_Count; j++) {
+					const auto & jointSettings = this->settings[j];
+					const int i = b * JointType_Count + j;
+					for (int c = 0; c < 3; c++) {
+						this->positionMinCutoff[i * 3 + c] = jointSettings.minCutoff;
+						this->positionBeta[i * 3 + c] = jointSettings.beta;
+						this->positionDerivativeCutoff[i * 3 + c] = jointSettings.derivativeCutoff;
+						this->positionSmoothing[i * 3 + c] = jointSettings.smoothing;
+						this->positionCorrection[i * 3 + c] = jointSettings.correction;
+						this->positionPrediction[i * 3 + c] = jointSettings.prediction;
+					}
+					for (int c = 0; c < 4; c++) {
+						this->orientationMinCutoff[i * 4 + c] = jointSettings.minCutoff;
+						this->orientationBeta[i * 4 + c] = jointSettings.beta;
+						this->orientationDerivativeCutoff[i * 4 + c] = jointSettings.derivativeCutoff;
+						this->orientationSmoothing[i * 4 + c] = jointSettings.smoothing;
+						this->orientationCorrection[i * 4 + c] = jointSettings.correction;
+						this->orientationPrediction[i * 4 + c] = jointSettings.prediction;
+					}
+				}
+			}
+		}
+
+		//----------
+		void BodyFilter::resetBody(int bodyIndex) {
+			const int positionOffset = bodyIndex * JointType_Count * 3;
+			const int orientationOffset = bodyIndex * JointType_Count * 4;
+			for (int i = 0; i < JointType_Count * 3; i++) {
+				this->positionPrevious[positionOffset + i] = this->positionInput[positionOffset + i];
+				this->positionTrend[positionOffset + i] = 0.0f;
+			}
+			for (int i = 0; i < JointType_Count * 4; i++) {
+				this->orientationPrevious[orientationOffset + i] = this->orientationInput[orientationOffset + i];
+				this->orientationTrend[orientationOffset + i] = 0.0f;
+			}
+		}
+	}
+}
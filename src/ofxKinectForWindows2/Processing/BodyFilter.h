@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Smooths joint positions and orientations of all bodies in one pass.
+		// State is held per body slot and reset whenever the slot's trackingId changes
+		// (including when tracking is lost, i.e. trackingId becomes 0).
+		// All lanes (body x joint x component) are stored contiguously so that the
+		// filter kernels are flat loops over float arrays.
+		class BodyFilter {
+		public:
+			enum Mode {
+				None,
+				OneEuro,
+				DoubleExponential
+			};
+
+			struct Settings {
+				Settings();
+
+				// One Euro filter (Casiez et al. 2012)
+				float minCutoff; // Hz
+				float beta;
+				float derivativeCutoff; // Hz
+
+				// Double exponential / Holt filter (as in the Kinect v1 SDK)
+				float smoothing;
+				float correction;
+				float prediction;
+				float jitterRadius; // m
+				float maxDeviationRadius; // m
+			};
+
+			static const int PositionLaneCount = BODY_COUNT * JointType_Count * 3;
+			static const int OrientationLaneCount = BODY_COUNT * JointType_Count * 4;
+
+			BodyFilter();
+
+			void setMode(Mode);
+			Mode getMode() const;
+
+			void setFilterOrientations(bool);
+			bool getFilterOrientations() const;
+
+			// Apply to all joints
+			void setSettings(const Settings &);
+			// Apply to one joint (e.g. hands want less smoothing than the spine)
+			void setSettings(JointType, const Settings &);
+			const Settings & getSettings(JointType) const;
+
+			// joints and jointOrientations are BODY_COUNT * JointType_Count entries, body major.
+			// trackingIds has BODY_COUNT entries, 0 for bodies which are not tracked.
+			// relativeTime is the frame's RelativeTime (100ns ticks).
+			void apply(_Joint * joints, _JointOrientation * jointOrientations, const UINT64 * trackingIds, INT64 relativeTime);
+
+			// Forget all history
+			void reset();
+
+			// Duration of the last call to apply() in microseconds
+			float getLastApplyDuration() const;
+		protected:
+			void updateLaneSettings();
+			void resetBody(int bodyIndex);
+
+			Mode mode;
+			bool filterOrientations;
+			Settings settings[JointType_Count];
+
+			UINT64 trackingIds[BODY_COUNT];
+			INT64 lastRelativeTime;
+
+			// Per lane settings, expanded from per joint settings
+			float positionMinCutoff[PositionLaneCount];
+			float positionBeta[PositionLaneCount];
+			float positionDerivativeCutoff[PositionLaneCount];
+			float positionSmoothing[PositionLaneCount];
+			float positionCorrection[PositionLaneCount];
+			float positionPrediction[PositionLaneCount];
+			float orientationMinCutoff[OrientationLaneCount];
+			float orientationBeta[OrientationLaneCount];
+			float orientationDerivativeCutoff[OrientationLaneCount];
+			float orientationSmoothing[OrientationLaneCount];
+			float orientationCorrection[OrientationLaneCount];
+			float orientationPrediction[OrientationLaneCount];
+
+			// Working data
+			float positionInput[PositionLaneCount];
+			float positionOutput[PositionLaneCount];
+			float positionPrevious[PositionLaneCount];
+			float positionTrend[PositionLaneCount]; // derivative for One Euro, trend for double exponential
+			float orientationInput[OrientationLaneCount];
+			float orientationOutput[OrientationLaneCount];
+			float orientationPrevious[OrientationLaneCount];
+			float orientationTrend[OrientationLaneCount];
+
+			float lastApplyDuration;
+		};
+	}
+}
@@ -0,0 +1,203 @@
+#include "BodyHistory.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		BodyHistory::BodyHistory() {
+			this->length = 0;
+			this->setLength(30);
+		}
+
+		//----------
+		void BodyHistory::setLength(int length) {
+			if (length < 2) {
+				OFXKINECTFORWINDOWS2_WARNING << "History length must be at least 2 frames";
+				length = 2;
+			}
+			this->length = length;
+			this->frames.assign(BODY_COUNT * length, Frame());
+			this->clear();
+		}
+
+		//----------
+		int BodyHistory::getLength() const {
+			return this->length;
+		}
+
+		//----------
+		void BodyHistory::add(const vector<Data::Body> & bodies, INT64 relativeTime) {
+			for (int b = 0; b < BODY_COUNT && b < (int) bodies.size(); b++) {
+				const auto & body = bodies[b];
+				auto & ring = this->rings[b];
+
+				if (!body.tracked) {
+					ring.trackingId = 0;
+					ring.count = 0;
+					continue;
+				}
+
+				if (body.trackingId != ring.trackingId) {
+					ring.trackingId = body.trackingId;
+					ring.count = 0;
+				}
+
+				//ignore repeated frames
+				if (ring.count > 0 && this->at(b, 0).relativeTime >= relativeTime) {
+					continue;
+				}
+
+				ring.head = (ring.head + 1) % this->length;
+				if (ring.count < this->length) {
+					ring.count++;
+				}
+
+				auto & frame = this->at(b, 0);
+				frame.relativeTime = relativeTime;
+				frame.leftHandState = body.leftHandState;
+				frame.rightHandState = body.rightHandState;
+
+				const auto & jointArrays = body.jointArrays;
+				std::copy(jointArrays.positions, jointArrays.positions + JointType_Count, frame.positions);
+				std::copy(jointArrays.trackingStates, jointArrays.trackingStates + JointType_Count, frame.trackingStates);
+				std::copy(jointArrays.orientations, jointArrays.orientations + JointType_Count, frame.orientations);
+
+				if (ring.count == 1) {
+					for (int j = 0; j < JointType_Count; j++) {
+						frame.velocities[j] = ofVec3f();
+						frame.accelerations[j] = ofVec3f();
+					}
+				}
+				else {
+					const auto & previous = this->at(b, 1);
+					const float rate = 10000000.0f / (float)(relativeTime - previous.relativeTime);
+					for (int j = 0; j < JointType_Count; j++) {
+						frame.velocities[j] = (frame.positions[j] - previous.positions[j]) * rate;
+					}
+					if (ring.count == 2) {
+						for (int j = 0; j < JointType_Count; j++) {
+							frame.accelerations[j] = ofVec3f();
+						}
+					}
+					else {
+						for (int j = 0; j < JointType_Count; j++) {
+							frame.accelerations[j] = (frame.velocities[j] - previous.velocities[j]) * rate;
+						}
+					}
+				}
+			}
+		}
+
+		//----------
+		void BodyHistory::clear() {
+			for (auto & ring : this->rings) {
+				ring.trackingId = 0;
+				ring.head = 0;
+				ring.count = 0;
+			}
+		}
+
+		//----------
+		int BodyHistory::getBodyIndex(UINT64 trackingId) const {
+			for (int b = 0; b < BODY_COUNT; b++) {
+				if (this->rings[b].trackingId == trackingId && trackingId != 0) {
+					return b;
+				}
+			}
+			return -1;
+		}
+
+		//----------
+		UINT64 BodyHistory::getTrackingId(int bodyIndex) const {
+			return this->rings[bodyIndex].trackingId;
+		}
+
+		//----------
+		int BodyHistory::getCount(int bodyIndex) const {
+			return this->rings[bodyIndex].count;
+		}
+
+		//----------
+		const BodyHistory::Frame & BodyHistory::getFrame(int bodyIndex, int age) const {
+			const auto & ring = this->rings[bodyIndex];
+			if (age < 0 || age >= ring.count) {
+				throw Exception("BodyHistory frame age out of range");
+			}
+			return this->frames[bodyIndex * this->length + (ring.head - age + this->length) % this->length];
+		}
+
+		//----------
+		ofVec3f BodyHistory::getPosition(int bodyIndex, JointType jointType, int age) const {
+			return this->getFrame(bodyIndex, age).positions[jointType];
+		}
+
+		//----------
+		ofVec3f BodyHistory::getVelocity(int bodyIndex, JointType jointType, int age) const {
+			return this->getFrame(bodyIndex, age).velocities[jointType];
+		}
+
+		//----------
+		ofVec3f BodyHistory::getAcceleration(int bodyIndex, JointType jointType, int age) const {
+			return this->getFrame(bodyIndex, age).accelerations[jointType];
+		}
+
+		//----------
+		bool BodyHistory::sample(int bodyIndex, INT64 relativeTime, Data::Body & result, Extrapolation extrapolation, INT64 maxExtrapolation) const {
+			const auto & ring = this->rings[bodyIndex];
+			if (ring.count == 0) {
+				return false;
+			}
+
+			auto & jointArrays = result.jointArrays;
+			const auto & latest = this->getFrame(bodyIndex, 0);
+
+			if (relativeTime >= latest.relativeTime) {
+				//extrapolate forwards
+				float dt = (float) std::min(relativeTime - latest.relativeTime, maxExtrapolation) / 10000000.0f;
+				float halfDt2 = extrapolation == ConstantAcceleration ? 0.5f * dt * dt : 0.0f;
+				if (extrapolation == NoExtrapolation) {
+					dt = 0.0f;
+				}
+				for (int j = 0; j < JointType_Count; j++) {
+					jointArrays.positions[j] = latest.positions[j] + latest.velocities[j] * dt + latest.accelerations[j] * halfDt2;
+				}
+				std::copy(latest.orientations, latest.orientations + JointType_Count, jointArrays.orientations);
+				std::copy(latest.trackingStates, latest.trackingStates + JointType_Count, jointArrays.trackingStates);
+			}
+			else {
+				//find the frames either side
+				int age = 1;
+				while (age < ring.count - 1 && this->getFrame(bodyIndex, age).relativeTime > relativeTime) {
+					age++;
+				}
+				if (age >= ring.count) {
+					//only one frame stored
+					age = ring.count - 1;
+				}
+				const auto & before = this->getFrame(bodyIndex, age);
+				const auto & after = this->getFrame(bodyIndex, age - 1 >= 0 ? age - 1 : 0);
+
+				float ratio = 0.0f;
+				if (after.relativeTime > before.relativeTime) {
+					ratio = ofClamp((float)(relativeTime - before.relativeTime) / (float)(after.relativeTime - before.relativeTime), 0.0f, 1.0f);
+				}
+
+				for (int j = 0; j < JointType_Count; j++) {
+					jointArrays.positions[j] = before.positions[j] + (after.positions[j] - before.positions[j]) * ratio;
+					jointArrays.orientations[j].slerp(ratio, before.orientations[j], after.orientations[j]);
+				}
+				const auto & nearest = ratio < 0.5f ? before : after;
+				std::copy(nearest.trackingStates, nearest.trackingStates + JointType_Count, jointArrays.trackingStates);
+			}
+
+			result.applyJointArrays();
+			return true;
+		}
+
+		//----------
+		BodyHistory::Frame & BodyHistory::at(int bodyIndex, int age) {
+			const auto & ring = this->rings[bodyIndex];
+			return this->frames[bodyIndex * this->length + (ring.head - age + this->length) % this->length];
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Data/Body.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Keeps the last N frames of every tracked body in preallocated rings.
+		// Velocity and acceleration are computed by finite differences as frames are added,
+		// so reading them is free. A body slot's ring is emptied when its trackingId changes.
+		class BodyHistory {
+		public:
+			enum Extrapolation {
+				NoExtrapolation, // hold the latest frame
+				ConstantVelocity,
+				ConstantAcceleration
+			};
+
+			struct Frame {
+				INT64 relativeTime; // 100ns ticks
+				HandState leftHandState;
+				HandState rightHandState;
+				ofVec3f positions[JointType_Count]; // m
+				ofVec3f velocities[JointType_Count]; // m/s
+				ofVec3f accelerations[JointType_Count]; // m/s^2
+				ofQuaternion orientations[JointType_Count];
+				TrackingState trackingStates[JointType_Count];
+			};
+
+			BodyHistory();
+
+			// Number of frames kept per body. Reallocates and clears the history.
+			void setLength(int);
+			int getLength() const;
+
+			// Add the current frame for all bodies
+			void add(const vector<Data::Body> &, INT64 relativeTime);
+			void clear();
+
+			// Body slot currently tracking this id, or -1
+			int getBodyIndex(UINT64 trackingId) const;
+			UINT64 getTrackingId(int bodyIndex) const;
+
+			// Number of frames stored for this body (up to getLength())
+			int getCount(int bodyIndex) const;
+
+			// age 0 is the latest frame, age getCount() - 1 the oldest
+			const Frame & getFrame(int bodyIndex, int age = 0) const;
+
+			ofVec3f getPosition(int bodyIndex, JointType, int age = 0) const;
+			ofVec3f getVelocity(int bodyIndex, JointType, int age = 0) const;
+			ofVec3f getAcceleration(int bodyIndex, JointType, int age = 0) const;
+
+			// Resample the body's joints at any relativeTime (100ns ticks).
+			// Between stored frames positions are interpolated linearly and orientations with slerp.
+			// After the latest frame positions are extrapolated (by at most maxExtrapolation ticks)
+			// and orientations are held. Writes result.jointArrays and result.joints, returns false
+			// if there is no history for this body.
+			bool sample(int bodyIndex, INT64 relativeTime, Data::Body & result, Extrapolation = ConstantVelocity, INT64 maxExtrapolation = 1000000) const;
+		protected:
+			struct Ring {
+				UINT64 trackingId;
+				int head; // index of the latest frame
+				int count;
+			};
+
+			Frame & at(int bodyIndex, int age);
+
+			int length;
+			Ring rings[BODY_COUNT];
+			vector<Frame> frames; // BODY_COUNT * length, body major
+		};
+	}
+}
@@ -0,0 +1,182 @@
+#include "BodyPointClouds.h"
+#include "../Threading/ThreadPool.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		BodyPointClouds::BodyPointClouds() {
+			this->bandCount = 16;
+			this->hasTextureCoordinates = false;
+			for (auto & count : this->counts) {
+				count = 0;
+			}
+		}
+
+		//----------
+		bool BodyPointClouds::update(const Source::Depth & depth, const Source::BodyIndex & bodyIndex, bool colorTextureCoordinates) {
+			return this->update(depth.getPixels(), bodyIndex.getPixels(), depth.getCoordinateMapper(), colorTextureCoordinates);
+		}
+
+		//----------
+		bool BodyPointClouds::update(const ofShortPixels & depth, const ofPixels & bodyIndex, ICoordinateMapper * coordinateMapper, bool colorTextureCoordinates) {
+			const int width = (int) depth.getWidth();
+			const int height = (int) depth.getHeight();
+			const int frameSize = width * height;
+
+			if (!depth.isAllocated() || !bodyIndex.isAllocated() || !coordinateMapper) {
+				return false;
+			}
+			if (bodyIndex.getWidth() != width || bodyIndex.getHeight() != height) {
+				OFXKINECTFORWINDOWS2_ERROR << "Depth and BodyIndex frames have different sizes";
+				return false;
+			}
+			if (!this->updateDepthToCameraTable(coordinateMapper, width, height)) {
+				return false;
+			}
+
+			this->hasTextureCoordinates = colorTextureCoordinates;
+			if (colorTextureCoordinates) {
+				this->colorSpacePoints.resize(frameSize);
+				if (FAILED(coordinateMapper->MapDepthFrameToColorSpace(frameSize, depth.getData(), frameSize, this->colorSpacePoints.data()))) {
+					OFXKINECTFORWINDOWS2_ERROR << "MapDepthFrameToColorSpace failed";
+					this->hasTextureCoordinates = false;
+				}
+			}
+
+			const int bandCount = std::min(this->bandCount, height);
+			const int rowsPerBand = (height + bandCount - 1) / bandCount;
+			const unsigned short * depthData = depth.getData();
+			const unsigned char * bodyIndexData = bodyIndex.getData();
+			auto & pool = Threading::ThreadPool::getDefault();
+			this->bandOffsets.assign(bandCount * BODY_COUNT, 0);
+
+			//count points per body in each band
+			pool.parallelFor(bandCount, [&](int band) {
+				int * bandCounts = this->bandOffsets.data() + band * BODY_COUNT;
+				const int begin = band * rowsPerBand * width;
+				const int end = std::min(begin + rowsPerBand * width, frameSize);
+				for (int i = begin; i < end; i++) {
+					const unsigned char index = bodyIndexData[i];
+					if (index < BODY_COUNT && depthData[i] != 0) {
+						bandCounts[index]++;
+					}
+				}
+			});
+
+			//turn counts into write offsets, grow buffers if needed
+			for (int b = 0; b < BODY_COUNT; b++) {
+				int total = 0;
+				for (int band = 0; band < bandCount; band++) {
+					int & offset = this->bandOffsets[band * BODY_COUNT + b];
+					int bandPoints = offset;
+					offset = total;
+					total += bandPoints;
+				}
+				this->counts[b] = total;
+				if (this->positions[b].size() < total) {
+					this->positions[b].resize(total);
+				}
+				if (this->hasTextureCoordinates && this->textureCoordinates[b].size() < total) {
+					this->textureCoordinates[b].resize(total);
+				}
+			}
+
+			//scatter
+			const bool writeTextureCoordinates = this->hasTextureCoordinates;
+			pool.parallelFor(bandCount, [&](int band) {
+				int offsets[BODY_COUNT];
+				std::copy(this->bandOffsets.data() + band * BODY_COUNT, this->bandOffsets.data() + (band + 1) * BODY_COUNT, offsets);
+				ofVec3f * positions[BODY_COUNT];
+				ofVec2f * textureCoordinates[BODY_COUNT];
+				for (int b = 0; b < BODY_COUNT; b++) {
+					positions[b] = this->positions[b].data();
+					textureCoordinates[b] = writeTextureCoordinates ? this->textureCoordinates[b].data() : nullptr;
+				}
+
+				const int begin = band * rowsPerBand * width;
+				const int end = std::min(begin + rowsPerBand * width, frameSize);
+				for (int i = begin; i < end; i++) {
+					const unsigned char index = bodyIndexData[i];
+					const unsigned short depth = depthData[i];
+					if (index >= BODY_COUNT || depth == 0) {
+						continue;
+					}
+
+					const int offset = offsets[index]++;
+					const float z = (float) depth * 0.001f;
+					const auto & ray = this->depthToCameraTable[i];
+					positions[index][offset].set(ray.X * z, ray.Y * z, z);
+					if (writeTextureCoordinates) {
+						const auto & colorSpacePoint = this->colorSpacePoints[i];
+						textureCoordinates[index][offset].set(colorSpacePoint.X, colorSpacePoint.Y);
+					}
+				}
+			});
+
+			return true;
+		}
+
+		//----------
+		void BodyPointClouds::setBandCount(int bandCount) {
+			this->bandCount = std::max(bandCount, 1);
+		}
+
+		//----------
+		int BodyPointClouds::getBandCount() const {
+			return this->bandCount;
+		}
+
+		//----------
+		int BodyPointClouds::getCount(int bodyIndex) const {
+			return this->counts[bodyIndex];
+		}
+
+		//----------
+		const ofVec3f * BodyPointClouds::getPositions(int bodyIndex) const {
+			return this->positions[bodyIndex].data();
+		}
+
+		//----------
+		const ofVec2f * BodyPointClouds::getTextureCoordinates(int bodyIndex) const {
+			return this->hasTextureCoordinates ? this->textureCoordinates[bodyIndex].data() : nullptr;
+		}
+
+		//----------
+		void BodyPointClouds::getMesh(int bodyIndex, ofMesh & mesh) const {
+			const int count = this->counts[bodyIndex];
+			mesh.clear();
+			mesh.setMode(OF_PRIMITIVE_POINTS);
+			auto & vertices = mesh.getVertices();
+			vertices.assign(this->positions[bodyIndex].begin(), this->positions[bodyIndex].begin() + count);
+			if (this->hasTextureCoordinates) {
+				auto & texCoords = mesh.getTexCoords();
+				texCoords.assign(this->textureCoordinates[bodyIndex].begin(), this->textureCoordinates[bodyIndex].begin() + count);
+			}
+		}
+
+		//----------
+		bool BodyPointClouds::updateDepthToCameraTable(ICoordinateMapper * coordinateMapper, int width, int height) {
+			if (this->depthToCameraTable.size() == width * height) {
+				return true;
+			}
+
+			//the table is only available once the sensor has reported its intrinsics
+			UINT32 tableEntryCount;
+			PointF * tableEntries;
+			if (FAILED(coordinateMapper->GetDepthFrameToCameraSpaceTable(&tableEntryCount, &tableEntries))) {
+				return false;
+			}
+			bool success = tableEntryCount == width * height;
+			if (success) {
+				this->depthToCameraTable.assign(tableEntries, tableEntries + tableEntryCount);
+			}
+			else {
+				OFXKINECTFORWINDOWS2_ERROR << "wrong tableEntryCount";
+			}
+			// The table of camera space points must be released with a call to CoTaskMemFree
+			CoTaskMemFree(tableEntries);
+			return success;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Source/Depth.h"
+#include "../Source/BodyIndex.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Splits the depth frame into one compact point cloud per body index.
+		// The frame is cut into row bands which are processed in parallel twice :
+		// a counting pass gives every band its write offset for each body, then a scatter pass writes
+		// camera space points (and optionally color space texture coordinates) straight into
+		// preallocated per-body buffers, which only ever grow.
+		class BodyPointClouds {
+		public:
+			BodyPointClouds();
+
+			// Returns false if the frames aren't available or don't match
+			bool update(const Source::Depth &, const Source::BodyIndex &, bool colorTextureCoordinates = false);
+			bool update(const ofShortPixels & depth, const ofPixels & bodyIndex, ICoordinateMapper *, bool colorTextureCoordinates = false);
+
+			void setBandCount(int);
+			int getBandCount() const;
+
+			int getCount(int bodyIndex) const;
+			const ofVec3f * getPositions(int bodyIndex) const; // m, camera space
+			const ofVec2f * getTextureCoordinates(int bodyIndex) const; // color frame pixels, nullptr unless requested
+
+			// Point cloud of one body as an OF_PRIMITIVE_POINTS mesh
+			void getMesh(int bodyIndex, ofMesh &) const;
+		protected:
+			bool updateDepthToCameraTable(ICoordinateMapper *, int width, int height);
+
+			int bandCount;
+
+			vector<PointF> depthToCameraTable;
+			vector<ColorSpacePoint> colorSpacePoints;
+
+			vector<int> bandOffsets; // bandCount x BODY_COUNT
+			int counts[BODY_COUNT];
+			vector<ofVec3f> positions[BODY_COUNT];
+			vector<ofVec2f> textureCoordinates[BODY_COUNT];
+			bool hasTextureCoordinates;
+		};
+	}
+}
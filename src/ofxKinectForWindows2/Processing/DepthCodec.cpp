@@ -0,0 +1,239 @@
+#include "DepthCodec.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define OFXKFW2_DEPTHCODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+//size of one interval of the coarse channel in mm
+#define COARSE_STEP ((float) ofxKinectForWindows2::Processing::DepthCodec::Range / 255.0f)
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		static inline void encodePixel(unsigned int depth, unsigned char * rgb) {
+			depth = depth < DepthCodec::Range ? depth : DepthCodec::Range - 1;
+			const unsigned int halfPeriod = DepthCodec::Period / 2;
+
+			//depth * 255 / Range
+			rgb[0] = (unsigned char) ((depth * 2040) >> 16);
+
+			//triangle waves over [0, halfPeriod], scaled to [0, 255]
+			unsigned int phase = depth & (DepthCodec::Period - 1);
+			unsigned int triangle = phase < halfPeriod ? phase : DepthCodec::Period - phase;
+			rgb[1] = (unsigned char) ((triangle * 255) >> 8);
+
+			phase = (depth + DepthCodec::Period * 3 / 4) & (DepthCodec::Period - 1);
+			triangle = phase < halfPeriod ? phase : DepthCodec::Period - phase;
+			rgb[2] = (unsigned char) ((triangle * 255) >> 8);
+		}
+
+		//----------
+		static inline unsigned short decodePixel(const unsigned char * rgb) {
+			//the two waves split the period into quarters (by which of them are above half height), and each
+			//quarter reads both waves on their linear parts. Their mean gives the position within the period.
+			const float waveA = (float) rgb[1] * (256.0f / 255.0f);
+			const float waveB = (float) rgb[2] * (256.0f / 255.0f);
+			const bool highA = waveA >= 128.0f;
+			const bool highB = waveB >= 128.0f;
+			const float fromA = highB ? 512.0f - waveA : waveA;
+			const float fromB = highA ? waveB + 128.0f : (highB ? 640.0f - waveB : 128.0f - waveB);
+			const float phase = (fromA + fromB) * 0.5f;
+
+			//the coarse depth only chooses the period
+			const float coarse = (rgb[0] + 0.5f) * COARSE_STEP;
+			const float periods = floorf((coarse - phase) * (1.0f / DepthCodec::Period) + 0.5f);
+
+			const int depth = (int) (phase + periods * DepthCodec::Period + 0.5f);
+			if (depth < DepthCodec::MinimumDepth) {
+				return 0;
+			}
+			return (unsigned short) (depth >= DepthCodec::Range ? DepthCodec::Range - 1 : depth);
+		}
+
+		//----------
+		void DepthCodec::encode(const ofShortPixels & depth, ofPixels & rgb) {
+			if (rgb.getWidth() != depth.getWidth() || rgb.getHeight() != depth.getHeight() || rgb.getNumChannels() != 3) {
+				rgb.allocate(depth.getWidth(), depth.getHeight(), OF_IMAGE_COLOR);
+			}
+			const unsigned short * in = depth.getData();
+			unsigned char * out = rgb.getData();
+			const size_t count = depth.getWidth() * depth.getHeight();
+			size_t i = 0;
+
+#ifdef OFXKFW2_DEPTHCODEC_SSE2
+			//8 pixels at a time in 16 bit lanes, interleaved to RGB on the way out
+			const __m128i maxDepth = _mm_set1_epi16(Range - 1);
+			const __m128i periodMask = _mm_set1_epi16(Period - 1);
+			const __m128i period = _mm_set1_epi16(Period);
+			const __m128i quarterShift = _mm_set1_epi16(Period * 3 / 4);
+			const __m128i coarseScale = _mm_set1_epi16(2040);
+			const __m128i waveScale = _mm_set1_epi16(255);
+			unsigned char channels[3][16];
+			for (; i + 8 <= count; i += 8) {
+				__m128i value = _mm_loadu_si128((const __m128i *) (in + i));
+				value = _mm_sub_epi16(value, _mm_subs_epu16(value, maxDepth)); // unsigned min
+
+				const __m128i coarse = _mm_mulhi_epu16(value, coarseScale);
+
+				__m128i phase = _mm_and_si128(value, periodMask);
+				__m128i waveA = _mm_min_epi16(phase, _mm_sub_epi16(period, phase));
+				waveA = _mm_srli_epi16(_mm_mullo_epi16(waveA, waveScale), 8);
+
+				phase = _mm_and_si128(_mm_add_epi16(value, quarterShift), periodMask);
+				__m128i waveB = _mm_min_epi16(phase, _mm_sub_epi16(period, phase));
+				waveB = _mm_srli_epi16(_mm_mullo_epi16(waveB, waveScale), 8);
+
+				_mm_storeu_si128((__m128i *) channels[0], _mm_packus_epi16(coarse, coarse));
+				_mm_storeu_si128((__m128i *) channels[1], _mm_packus_epi16(waveA, waveA));
+				_mm_storeu_si128((__m128i *) channels[2], _mm_packus_epi16(waveB, waveB));
+				unsigned char * pixel = out + i * 3;
+				for (int j = 0; j < 8; j++) {
+					pixel[0] = channels[0][j];
+					pixel[1] = channels[1][j];
+					pixel[2] = channels[2][j];
+					pixel += 3;
+				}
+			}
+#endif
+			for (; i < count; i++) {
+				encodePixel(in[i], out + i * 3);
+			}
+		}
+
+		//----------
+		void DepthCodec::decode(const ofPixels & rgb, ofShortPixels & depth) {
+			if (rgb.getNumChannels() < 3) {
+				OFXKINECTFORWINDOWS2_ERROR << "Encoded depth must have RGB pixels";
+				return;
+			}
+			if (depth.getWidth() != rgb.getWidth() || depth.getHeight() != rgb.getHeight() || depth.getNumChannels() != 1) {
+				depth.allocate(rgb.getWidth(), rgb.getHeight(), OF_IMAGE_GRAYSCALE);
+			}
+			const unsigned char * in = rgb.getData();
+			const size_t stride = rgb.getNumChannels();
+			unsigned short * out = depth.getData();
+			const size_t count = rgb.getWidth() * rgb.getHeight();
+			size_t i = 0;
+
+#ifdef OFXKFW2_DEPTHCODEC_SSE2
+			//4 pixels at a time in float lanes, same steps as decodePixel
+			const __m128 coarseStep = _mm_set1_ps(COARSE_STEP);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 waveScale = _mm_set1_ps(256.0f / 255.0f);
+			const __m128 halfHeight = _mm_set1_ps(128.0f);
+			const __m128 fallingA = _mm_set1_ps(512.0f);
+			const __m128 fallingB = _mm_set1_ps(640.0f);
+			const __m128 inversePeriod = _mm_set1_ps(1.0f / Period);
+			const __m128 periodF = _mm_set1_ps((float) Period);
+			//keeps the period count positive so that truncation is floor
+			const __m128 periodBias = _mm_set1_ps(0.5f + 8.0f);
+			const __m128i eight = _mm_set1_epi32(8);
+			const __m128i minimumDepth = _mm_set1_epi32(MinimumDepth - 1);
+			const __m128i maxDepth = _mm_set1_epi32(Range - 1);
+			for (; i + 4 <= count; i += 4) {
+				const unsigned char * pixel = in + i * stride;
+				const __m128i r = _mm_setr_epi32(pixel[0], pixel[stride], pixel[stride * 2], pixel[stride * 3]);
+				const __m128i g = _mm_setr_epi32(pixel[1], pixel[stride + 1], pixel[stride * 2 + 1], pixel[stride * 3 + 1]);
+				const __m128i b = _mm_setr_epi32(pixel[2], pixel[stride + 2], pixel[stride * 2 + 2], pixel[stride * 3 + 2]);
+
+				const __m128 waveA = _mm_mul_ps(_mm_cvtepi32_ps(g), waveScale);
+				const __m128 waveB = _mm_mul_ps(_mm_cvtepi32_ps(b), waveScale);
+				const __m128 highA = _mm_cmpge_ps(waveA, halfHeight);
+				const __m128 highB = _mm_cmpge_ps(waveB, halfHeight);
+				const __m128 fromA = _mm_or_ps(_mm_and_ps(highB, _mm_sub_ps(fallingA, waveA)), _mm_andnot_ps(highB, waveA));
+				__m128 fromB = _mm_or_ps(_mm_and_ps(highB, _mm_sub_ps(fallingB, waveB)), _mm_andnot_ps(highB, _mm_sub_ps(halfHeight, waveB)));
+				fromB = _mm_or_ps(_mm_and_ps(highA, _mm_add_ps(waveB, halfHeight)), _mm_andnot_ps(highA, fromB));
+				const __m128 phase = _mm_mul_ps(_mm_add_ps(fromA, fromB), half);
+
+				const __m128 coarse = _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(r), half), coarseStep);
+				const __m128i periods = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(coarse, phase), inversePeriod), periodBias)), eight);
+				const __m128 result = _mm_add_ps(phase, _mm_mul_ps(_mm_cvtepi32_ps(periods), periodF));
+
+				//round, zero below MinimumDepth, clamp to Range - 1 and narrow to 16 bit
+				__m128i value = _mm_cvttps_epi32(_mm_add_ps(result, half));
+				value = _mm_and_si128(value, _mm_cmpgt_epi32(value, minimumDepth));
+				const __m128i over = _mm_cmpgt_epi32(value, maxDepth);
+				value = _mm_or_si128(_mm_and_si128(over, maxDepth), _mm_andnot_si128(over, value));
+				value = _mm_packs_epi32(value, value);
+				_mm_storel_epi64((__m128i *) (out + i), value);
+			}
+#endif
+			for (; i < count; i++) {
+				out[i] = decodePixel(in + i * stride);
+			}
+		}
+
+		//----------
+		DepthCodec::RoundTripStats DepthCodec::measureRoundTrip(const vector<ofShortPixels> & frames, int channelNoise) {
+			RoundTripStats stats;
+			stats.pixelCount = 0;
+			stats.invalidErrors = 0;
+			stats.meanError = 0.0f;
+			stats.maxError = 0;
+			stats.encodeDuration = 0.0f;
+			stats.decodeDuration = 0.0f;
+			if (frames.empty()) {
+				return stats;
+			}
+
+			ofPixels encoded;
+			ofShortPixels decoded;
+			uint32_t random = 0x9E3779B9u; // fixed seed so runs are comparable
+			double errorSum = 0.0;
+			for (const auto & frame : frames) {
+				auto startTime = std::chrono::high_resolution_clock::now();
+				DepthCodec::encode(frame, encoded);
+				auto encodedTime = std::chrono::high_resolution_clock::now();
+
+				if (channelNoise > 0) {
+					unsigned char * data = encoded.getData();
+					for (size_t i = 0; i < encoded.size(); i++) {
+						random ^= random << 13;
+						random ^= random >> 17;
+						random ^= random << 5;
+						const int noisy = (int) data[i] + (int) (random % (2 * channelNoise + 1)) - channelNoise;
+						data[i] = (unsigned char) (noisy < 0 ? 0 : (noisy > 255 ? 255 : noisy));
+					}
+				}
+
+				auto decodeStartTime = std::chrono::high_resolution_clock::now();
+				DepthCodec::decode(encoded, decoded);
+				auto endTime = std::chrono::high_resolution_clock::now();
+				stats.encodeDuration += std::chrono::duration<float, std::micro>(encodedTime - startTime).count();
+				stats.decodeDuration += std::chrono::duration<float, std::micro>(endTime - decodeStartTime).count();
+
+				const unsigned short * original = frame.getData();
+				const unsigned short * result = decoded.getData();
+				const size_t count = frame.getWidth() * frame.getHeight();
+				for (size_t i = 0; i < count; i++) {
+					if (original[i] >= Range) {
+						continue;
+					}
+					const bool valid = original[i] >= MinimumDepth;
+					if (valid != (result[i] != 0)) {
+						stats.invalidErrors++;
+						continue;
+					}
+					if (!valid) {
+						continue;
+					}
+					const int error = abs((int) result[i] - (int) original[i]);
+					errorSum += error;
+					stats.maxError = std::max(stats.maxError, error);
+					stats.pixelCount++;
+				}
+			}
+
+			if (stats.pixelCount > 0) {
+				stats.meanError = (float) (errorSum / stats.pixelCount);
+			}
+			stats.encodeDuration /= frames.size();
+			stats.decodeDuration /= frames.size();
+			return stats;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include "ofPixels.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Packs depth (millimetres) into 8 bit RGB so it survives video links and lossy codecs, and unpacks it.
+		// Uses triangle wave encoding : R is the coarse depth over the whole range, G and B are two triangle waves
+		// a quarter period apart which give the depth within each period. Neighbouring depths have neighbouring
+		// colours, so compression noise gives small depth errors rather than wrapping.
+		//	Range 0..8191mm (deeper values are clamped), period 512mm, resolution about 1mm.
+		//	G and B together give the position within the period, R only picks the period, so R may be off by up
+		//	to CoarseTolerance levels (+/-240mm) before decoding fails. Noise on G and B costs up to 2mm per level.
+		//	0 (invalid) stays 0 : decoded depths below MinimumDepth, which the sensor never reports, return 0.
+		class DepthCodec {
+		public:
+			enum {
+				Range = 8192,
+				Period = 512,
+				CoarseTolerance = 7,
+				MinimumDepth = 128
+			};
+
+			struct RoundTripStats {
+				int pixelCount; // valid depth pixels compared
+				int invalidErrors; // pixels which were invalid (0) before or after the round trip but not both
+				float meanError; // mm, over the valid pixels which stayed valid
+				int maxError; // mm
+				float encodeDuration; // microseconds per frame
+				float decodeDuration; // microseconds per frame
+			};
+
+			static void encode(const ofShortPixels & depth, ofPixels & rgb);
+			static void decode(const ofPixels & rgb, ofShortPixels & depth);
+
+			// Encodes and decodes the frames (e.g. recorded depth frames), optionally adding +/-channelNoise
+			// to every encoded channel to mimic a lossy video codec, and compares the result with the input.
+			static RoundTripStats measureRoundTrip(const vector<ofShortPixels> & frames, int channelNoise = 0);
+		};
+	}
+}
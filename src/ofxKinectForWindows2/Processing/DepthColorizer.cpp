@@ -0,0 +1,160 @@
+#include "DepthColorizer.h"
+#include "ofMain.h"
+
+// depths beyond the table all share the last entry (the sensor reports at most 8m)
+#define DEPTH_LOOKUP_TABLE_SIZE 8192
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		DepthColorizer::DepthColorizer() {
+			this->palette = None;
+			this->nearClip = 500;
+			this->farClip = 4500;
+			this->invalidColor = ofColor(0, 0, 0, 0);
+			this->clippedColor = ofColor(0, 0, 0, 0);
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		void DepthColorizer::setPalette(Palette palette) {
+			if (palette == Custom && this->customPalette.empty()) {
+				OFXKINECTFORWINDOWS2_WARNING << "Call setCustomPalette to select the Custom palette";
+				return;
+			}
+			this->palette = palette;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		DepthColorizer::Palette DepthColorizer::getPalette() const {
+			return this->palette;
+		}
+
+		//----------
+		void DepthColorizer::setCustomPalette(const vector<ofColor> & customPalette) {
+			if (customPalette.empty()) {
+				OFXKINECTFORWINDOWS2_WARNING << "Custom palette needs at least one colour";
+				return;
+			}
+			this->customPalette = customPalette;
+			this->palette = Custom;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		void DepthColorizer::setRange(unsigned short nearClip, unsigned short farClip) {
+			if (farClip <= nearClip) {
+				OFXKINECTFORWINDOWS2_WARNING << "Depth range must have far > near";
+				farClip = nearClip + 1;
+			}
+			this->nearClip = nearClip;
+			this->farClip = farClip;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		unsigned short DepthColorizer::getNear() const {
+			return this->nearClip;
+		}
+
+		//----------
+		unsigned short DepthColorizer::getFar() const {
+			return this->farClip;
+		}
+
+		//----------
+		void DepthColorizer::setInvalidColor(const ofColor & invalidColor) {
+			this->invalidColor = invalidColor;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		void DepthColorizer::setClippedColor(const ofColor & clippedColor) {
+			this->clippedColor = clippedColor;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		bool DepthColorizer::convert(const ofShortPixels & input, ofPixels & output) {
+			if (this->palette == None || !input.isAllocated()) {
+				return false;
+			}
+			if (output.getWidth() != input.getWidth() || output.getHeight() != input.getHeight() || output.getNumChannels() != 4) {
+				output.allocate(input.getWidth(), input.getHeight(), OF_IMAGE_COLOR_ALPHA);
+			}
+			if (this->lookupTableDirty) {
+				this->updateLookupTable();
+			}
+
+			//clipping and invalid pixels are baked into the table, so the loop is one clamp and one lookup per pixel
+			const unsigned short * in = input.getData();
+			uint32_t * out = (uint32_t *) output.getData();
+			const uint32_t * lookupTable = this->lookupTable.data();
+			const size_t count = input.getWidth() * input.getHeight();
+			for (size_t i = 0; i < count; i++) {
+				const unsigned int depth = in[i];
+				out[i] = lookupTable[depth < DEPTH_LOOKUP_TABLE_SIZE ? depth : DEPTH_LOOKUP_TABLE_SIZE - 1];
+			}
+			return true;
+		}
+
+		//----------
+		void DepthColorizer::updateLookupTable() {
+			this->lookupTable.resize(DEPTH_LOOKUP_TABLE_SIZE);
+			const float range = (float) (this->farClip - this->nearClip);
+			for (int i = 0; i < DEPTH_LOOKUP_TABLE_SIZE; i++) {
+				ofColor color;
+				if (i == 0) {
+					color = this->invalidColor;
+				}
+				else if (i < this->nearClip || i > this->farClip) {
+					color = this->clippedColor;
+				}
+				else {
+					color = this->getPaletteColor((i - this->nearClip) / range);
+				}
+				const unsigned char rgba[4] = { color.r, color.g, color.b, color.a };
+				memcpy(&this->lookupTable[i], rgba, 4);
+			}
+			this->lookupTableDirty = false;
+		}
+
+		//----------
+		ofColor DepthColorizer::getPaletteColor(float x) const {
+			switch (this->palette) {
+			case Jet:
+			{
+				const float r = ofClamp(1.5f - fabs(4.0f * x - 3.0f), 0.0f, 1.0f);
+				const float g = ofClamp(1.5f - fabs(4.0f * x - 2.0f), 0.0f, 1.0f);
+				const float b = ofClamp(1.5f - fabs(4.0f * x - 1.0f), 0.0f, 1.0f);
+				return ofColor(r * 255.0f, g * 255.0f, b * 255.0f);
+			}
+			case Turbo:
+			{
+				//polynomial fit of the Turbo colormap (Mikhailov, 2019)
+				const float r = 0.13572138f + x * (4.61539260f + x * (-42.66032258f + x * (132.13108234f + x * (-152.94239396f + x * 59.28637943f))));
+				const float g = 0.09140261f + x * (2.19418839f + x * (4.84296658f + x * (-14.18503333f + x * (4.27729857f + x * 2.82956604f))));
+				const float b = 0.10667330f + x * (12.64194608f + x * (-60.58204836f + x * (110.36276771f + x * (-89.90310912f + x * 27.34824973f))));
+				return ofColor(ofClamp(r, 0.0f, 1.0f) * 255.0f, ofClamp(g, 0.0f, 1.0f) * 255.0f, ofClamp(b, 0.0f, 1.0f) * 255.0f);
+			}
+			case Custom:
+			{
+				if (this->customPalette.size() == 1) {
+					return this->customPalette.front();
+				}
+				const float position = x * (this->customPalette.size() - 1);
+				const int index = ofClamp((int) position, 0, (int) this->customPalette.size() - 2);
+				return this->customPalette[index].getLerped(this->customPalette[index + 1], position - index);
+			}
+			case Gray:
+			default:
+			{
+				//near is bright
+				const unsigned char value = (unsigned char) ((1.0f - x) * 255.0f + 0.5f);
+				return ofColor(value, value, value);
+			}
+			}
+		}
+	}
+}
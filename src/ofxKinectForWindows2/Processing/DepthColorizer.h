@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include "ofPixels.h"
+#include "ofColor.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Converts depth frames (millimetres) to display ready RGBA pixels through an 8192 entry lookup table.
+		// Depths between near and far are spread across the palette, invalid (0) and clipped depths take
+		// their own colours (transparent by default). The table is rebuilt only when settings change,
+		// so each frame is a single lookup per pixel.
+		class DepthColorizer {
+		public:
+			enum Palette {
+				None, // no conversion
+				Gray,
+				Jet,
+				Turbo,
+				Custom
+			};
+
+			DepthColorizer();
+
+			void setPalette(Palette);
+			Palette getPalette() const;
+
+			// Colours spread evenly from near to far, selects the Custom palette
+			void setCustomPalette(const vector<ofColor> &);
+
+			void setRange(unsigned short nearClip, unsigned short farClip);
+			unsigned short getNear() const;
+			unsigned short getFar() const;
+
+			void setInvalidColor(const ofColor &);
+			void setClippedColor(const ofColor &);
+
+			// Returns false when the palette is None
+			bool convert(const ofShortPixels & input, ofPixels & output);
+		protected:
+			void updateLookupTable();
+			ofColor getPaletteColor(float) const;
+
+			Palette palette;
+			vector<ofColor> customPalette;
+			unsigned short nearClip;
+			unsigned short farClip;
+			ofColor invalidColor;
+			ofColor clippedColor;
+
+			vector<uint32_t> lookupTable;
+			bool lookupTableDirty;
+		};
+	}
+}
@@ -0,0 +1,176 @@
+#include "FrameAccumulator.h"
+#include "ofMain.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define OFXKFW2_ACCUMULATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		FrameAccumulator::FrameAccumulator() {
+			this->mode = None;
+			this->frameCount = 4;
+			this->exponentialWeight = 0.2f;
+			this->frameSize = 0;
+			this->head = -1;
+			this->count = 0;
+		}
+
+		//----------
+		void FrameAccumulator::setMode(Mode mode) {
+			if (mode != this->mode) {
+				this->mode = mode;
+				this->reset();
+			}
+		}
+
+		//----------
+		FrameAccumulator::Mode FrameAccumulator::getMode() const {
+			return this->mode;
+		}
+
+		//----------
+		void FrameAccumulator::setFrameCount(int frameCount) {
+			frameCount = ofClamp(frameCount, 1, 64);
+			if (frameCount != this->frameCount) {
+				this->frameCount = frameCount;
+				this->ring.assign(this->frameCount * this->frameSize, 0);
+				this->reset();
+			}
+		}
+
+		//----------
+		int FrameAccumulator::getFrameCount() const {
+			return this->frameCount;
+		}
+
+		//----------
+		void FrameAccumulator::setExponentialWeight(float exponentialWeight) {
+			this->exponentialWeight = ofClamp(exponentialWeight, 0.0f, 1.0f);
+		}
+
+		//----------
+		float FrameAccumulator::getExponentialWeight() const {
+			return this->exponentialWeight;
+		}
+
+		//----------
+		bool FrameAccumulator::process(ofShortPixels & pixels) {
+			if (this->mode == None || !pixels.isAllocated()) {
+				return false;
+			}
+
+			const size_t frameSize = pixels.size();
+			if (frameSize != this->frameSize) {
+				this->allocate(frameSize);
+			}
+			unsigned short * data = pixels.getData();
+
+			switch (this->mode) {
+			case Exponential:
+			{
+				float * average = this->average.data();
+				if (this->count == 0) {
+					for (size_t i = 0; i < frameSize; i++) {
+						average[i] = data[i];
+					}
+					this->count = 1;
+				}
+				else {
+					const float weight = this->exponentialWeight;
+					for (size_t i = 0; i < frameSize; i++) {
+						average[i] += (data[i] - average[i]) * weight;
+						data[i] = (unsigned short) (average[i] + 0.5f);
+					}
+				}
+				return true;
+			}
+			case Box:
+			case Median:
+			{
+				//push into the ring, remembering the frame which falls out
+				this->head = (this->head + 1) % this->frameCount;
+				unsigned short * slot = this->ring.data() + this->head * frameSize;
+				const bool full = this->count == this->frameCount;
+
+				if (this->mode == Box) {
+					uint32_t * sum = this->sum.data();
+					size_t i = 0;
+#ifdef OFXKFW2_ACCUMULATOR_SSE2
+					//sum += new - old, 8 pixels at a time
+					const __m128i zero = _mm_setzero_si128();
+					for (; i + 8 <= frameSize; i += 8) {
+						__m128i added = _mm_loadu_si128((const __m128i *) (data + i));
+						__m128i removed = full ? _mm_loadu_si128((const __m128i *) (slot + i)) : zero;
+						__m128i sumLow = _mm_loadu_si128((const __m128i *) (sum + i));
+						__m128i sumHigh = _mm_loadu_si128((const __m128i *) (sum + i + 4));
+						sumLow = _mm_sub_epi32(_mm_add_epi32(sumLow, _mm_unpacklo_epi16(added, zero)), _mm_unpacklo_epi16(removed, zero));
+						sumHigh = _mm_sub_epi32(_mm_add_epi32(sumHigh, _mm_unpackhi_epi16(added, zero)), _mm_unpackhi_epi16(removed, zero));
+						_mm_storeu_si128((__m128i *) (sum + i), sumLow);
+						_mm_storeu_si128((__m128i *) (sum + i + 4), sumHigh);
+					}
+#endif
+					for (; i < frameSize; i++) {
+						sum[i] += data[i];
+						if (full) {
+							sum[i] -= slot[i];
+						}
+					}
+				}
+
+				memcpy(slot, data, frameSize * sizeof(unsigned short));
+				if (!full) {
+					this->count++;
+				}
+
+				if (this->mode == Box) {
+					const uint32_t * sum = this->sum.data();
+					const float scale = 1.0f / (float) this->count;
+					for (size_t i = 0; i < frameSize; i++) {
+						data[i] = (unsigned short) ((float) sum[i] * scale + 0.5f);
+					}
+				}
+				else {
+					const int count = this->count;
+					const unsigned short * ring = this->ring.data();
+					unsigned short * values = this->medianScratch.data();
+					for (size_t i = 0; i < frameSize; i++) {
+						for (int f = 0; f < count; f++) {
+							values[f] = ring[f * frameSize + i];
+						}
+						std::nth_element(values, values + count / 2, values + count);
+						data[i] = values[count / 2];
+					}
+				}
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		//----------
+		void FrameAccumulator::reset() {
+			this->head = -1;
+			this->count = 0;
+			std::fill(this->sum.begin(), this->sum.end(), 0);
+		}
+
+		//----------
+		int FrameAccumulator::getCount() const {
+			return this->count;
+		}
+
+		//----------
+		void FrameAccumulator::allocate(size_t frameSize) {
+			this->frameSize = frameSize;
+			this->ring.assign(this->frameCount * frameSize, 0);
+			this->sum.assign(frameSize, 0);
+			this->average.assign(frameSize, 0.0f);
+			this->medianScratch.resize(64);
+			this->reset();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include "ofPixels.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Temporal noise reduction for 16 bit frames (e.g. infrared).
+		//	Box : mean of the last N frames, from an integer running sum (one add and one subtract per pixel whatever N)
+		//	Exponential : running average, weight of the newest frame set by setExponentialWeight
+		//	Median : per pixel median of the last N frames (rejects flicker, cost grows with N)
+		// Frames are kept in a preallocated ring, which is reset when the frame size or settings change.
+		class FrameAccumulator {
+		public:
+			enum Mode {
+				None,
+				Box,
+				Exponential,
+				Median
+			};
+
+			FrameAccumulator();
+
+			void setMode(Mode);
+			Mode getMode() const;
+
+			// N for Box and Median (default 4)
+			void setFrameCount(int);
+			int getFrameCount() const;
+
+			// 0..1, default 0.2
+			void setExponentialWeight(float);
+			float getExponentialWeight() const;
+
+			// Adds the frame and replaces it with the accumulated result. Returns false in None mode.
+			bool process(ofShortPixels &);
+			void reset();
+
+			// Frames currently in the ring
+			int getCount() const;
+		protected:
+			void allocate(size_t frameSize);
+
+			Mode mode;
+			int frameCount;
+			float exponentialWeight;
+
+			size_t frameSize;
+			int head; // ring slot of the latest frame
+			int count;
+			vector<unsigned short> ring; // frameCount x frameSize
+			vector<uint32_t> sum;
+			vector<float> average;
+			vector<unsigned short> medianScratch;
+		};
+	}
+}
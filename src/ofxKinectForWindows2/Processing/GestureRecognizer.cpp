@@ -0,0 +1,352 @@
+#include "GestureRecognizer.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		static inline float squaredDistance(const float * a, const float * b, int dimensions) {
+			float sum = 0.0f;
+			for (int i = 0; i < dimensions; i++) {
+				float difference = a[i] - b[i];
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		//----------
+		GestureRecognizer::GestureRecognizer() {
+			this->joints = {
+				JointType_HandLeft, JointType_WristLeft, JointType_ElbowLeft,
+				JointType_HandRight, JointType_WristRight, JointType_ElbowRight
+			};
+			this->bandRatio = 0.1f;
+			this->refractoryFrames = 15;
+			this->maxTemplateLength = 0;
+			this->matches.reserve(BODY_COUNT);
+		}
+
+		//----------
+		void GestureRecognizer::setJoints(const vector<JointType> & joints) {
+			if (!this->templates.empty()) {
+				OFXKINECTFORWINDOWS2_WARNING << "Changing joints clears all templates";
+				this->clearTemplates();
+			}
+			this->joints = joints;
+			this->allocateStreams();
+		}
+
+		//----------
+		const vector<JointType> & GestureRecognizer::getJoints() const {
+			return this->joints;
+		}
+
+		//----------
+		int GestureRecognizer::getDimensions() const {
+			return (int) this->joints.size() * 3;
+		}
+
+		//----------
+		void GestureRecognizer::setBandRatio(float bandRatio) {
+			this->bandRatio = bandRatio;
+			for (auto & gestureTemplate : this->templates) {
+				this->updateEnvelope(gestureTemplate);
+			}
+		}
+
+		//----------
+		void GestureRecognizer::setRefractoryFrames(int refractoryFrames) {
+			this->refractoryFrames = refractoryFrames;
+		}
+
+		//----------
+		int GestureRecognizer::addTemplate(const string & name, const vector<Data::Body> & frames, float threshold) {
+			const int dimensions = this->getDimensions();
+			vector<float> features;
+			features.reserve(frames.size() * dimensions);
+			vector<float> frameFeatures(dimensions);
+			for (const auto & frame : frames) {
+				if (this->computeFeatures(frame, frameFeatures.data())) {
+					features.insert(features.end(), frameFeatures.begin(), frameFeatures.end());
+				}
+			}
+			return this->addTemplate(name, features, threshold);
+		}
+
+		//----------
+		int GestureRecognizer::addTemplate(const string & name, const vector<float> & features, float threshold) {
+			const int dimensions = this->getDimensions();
+			if (dimensions == 0 || features.size() < dimensions * 2 || features.size() % dimensions != 0) {
+				OFXKINECTFORWINDOWS2_ERROR << "Template '" << name << "' needs at least 2 frames of " << dimensions << " features";
+				return -1;
+			}
+
+			Template gestureTemplate;
+			gestureTemplate.name = name;
+			gestureTemplate.length = (int) features.size() / dimensions;
+			gestureTemplate.threshold = threshold;
+			gestureTemplate.features = features;
+			this->updateEnvelope(gestureTemplate);
+			this->templates.push_back(gestureTemplate);
+
+			if (gestureTemplate.length > this->maxTemplateLength) {
+				this->maxTemplateLength = gestureTemplate.length;
+				this->allocateStreams();
+			}
+
+			return (int) this->templates.size() - 1;
+		}
+
+		//----------
+		const vector<GestureRecognizer::Template> & GestureRecognizer::getTemplates() const {
+			return this->templates;
+		}
+
+		//----------
+		void GestureRecognizer::clearTemplates() {
+			this->templates.clear();
+			this->maxTemplateLength = 0;
+			this->allocateStreams();
+		}
+
+		//----------
+		const vector<GestureRecognizer::Match> & GestureRecognizer::update(const vector<Data::Body> & bodies) {
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			this->matches.clear();
+			this->stats = Stats();
+
+			if (this->templates.empty()) {
+				return this->matches;
+			}
+
+			const int dimensions = this->getDimensions();
+			const int capacity = this->maxTemplateLength;
+
+			for (int b = 0; b < BODY_COUNT && b < (int) bodies.size(); b++) {
+				const auto & body = bodies[b];
+				auto & stream = this->streams[b];
+
+				if (!body.tracked || body.trackingId != stream.trackingId) {
+					stream.trackingId = body.tracked ? body.trackingId : 0;
+					stream.count = 0;
+					stream.head = capacity - 1;
+					stream.refractory = 0;
+					if (!body.tracked) {
+						continue;
+					}
+				}
+
+				//push the frame (twice, so that any window is contiguous)
+				const int head = (stream.head + 1) % capacity;
+				float * frame = stream.features.data() + head * dimensions;
+				if (!this->computeFeatures(body, frame)) {
+					continue;
+				}
+				std::copy(frame, frame + dimensions, frame + capacity * dimensions);
+				stream.head = head;
+				if (stream.count < capacity) {
+					stream.count++;
+				}
+
+				if (stream.refractory > 0) {
+					stream.refractory--;
+					continue;
+				}
+
+				//find the best matching template
+				float best = std::numeric_limits<float>::infinity();
+				int bestIndex = -1;
+				const float * newest = stream.features.data() + (head + capacity) * dimensions;
+
+				for (int t = 0; t < (int) this->templates.size(); t++) {
+					const auto & gestureTemplate = this->templates[t];
+					const int length = gestureTemplate.length;
+					if (stream.count < length) {
+						continue;
+					}
+					this->stats.comparisons++;
+
+					const float threshold = std::min(gestureTemplate.threshold, best);
+					const float totalThreshold = threshold * length;
+					const float * candidate = newest - (length - 1) * dimensions;
+					const float * features = gestureTemplate.features.data();
+
+					//LB_Kim : first and last frames must be aligned in any warping path
+					float lowerBound = squaredDistance(candidate, features, dimensions)
+						+ squaredDistance(newest, features + (length - 1) * dimensions, dimensions);
+					if (lowerBound > totalThreshold) {
+						this->stats.prunedByKim++;
+						continue;
+					}
+
+					//LB_Keogh : distance of the candidate to the template's envelope
+					{
+						const float * upper = gestureTemplate.upper.data();
+						const float * lower = gestureTemplate.lower.data();
+						const int count = length * dimensions;
+						lowerBound = 0.0f;
+						bool pruned = false;
+						for (int rowStart = 0; rowStart < count && !pruned; rowStart += dimensions) {
+							for (int i = rowStart; i < rowStart + dimensions; i++) {
+								float value = candidate[i];
+								float above = std::max(value - upper[i], 0.0f);
+								float below = std::max(lower[i] - value, 0.0f);
+								lowerBound += above * above + below * below;
+							}
+							pruned = lowerBound > totalThreshold;
+						}
+						if (pruned) {
+							this->stats.prunedByKeogh++;
+							continue;
+						}
+					}
+
+					float distance = this->dtw(features, length, candidate, length, threshold);
+					if (distance < threshold) {
+						best = distance;
+						bestIndex = t;
+					}
+					else {
+						this->stats.abandonedDtw++;
+					}
+				}
+
+				if (bestIndex >= 0) {
+					Match match;
+					match.body = b;
+					match.trackingId = body.trackingId;
+					match.templateIndex = bestIndex;
+					match.distance = best;
+					this->matches.push_back(match);
+					stream.refractory = this->refractoryFrames;
+				}
+			}
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			this->stats.duration = std::chrono::duration<float, std::micro>(endTime - startTime).count();
+
+			return this->matches;
+		}
+
+		//----------
+		const vector<GestureRecognizer::Match> & GestureRecognizer::getMatches() const {
+			return this->matches;
+		}
+
+		//----------
+		const GestureRecognizer::Stats & GestureRecognizer::getStats() const {
+			return this->stats;
+		}
+
+		//----------
+		void GestureRecognizer::reset() {
+			for (auto & stream : this->streams) {
+				stream.trackingId = 0;
+				stream.count = 0;
+				stream.refractory = 0;
+			}
+			this->matches.clear();
+		}
+
+		//----------
+		bool GestureRecognizer::computeFeatures(const Data::Body & body, float * features) const {
+			const auto & positions = body.jointArrays.positions;
+			const ofVec3f & origin = positions[JointType_SpineShoulder];
+			const float scale = origin.distance(positions[JointType_SpineBase]);
+			if (scale < 1e-3f) {
+				return false;
+			}
+			const float inverseScale = 1.0f / scale;
+
+			for (const auto & jointType : this->joints) {
+				const ofVec3f & position = positions[jointType];
+				*features++ = (position.x - origin.x) * inverseScale;
+				*features++ = (position.y - origin.y) * inverseScale;
+				*features++ = (position.z - origin.z) * inverseScale;
+			}
+			return true;
+		}
+
+		//----------
+		float GestureRecognizer::dtw(const float * a, int aLength, const float * b, int bLength, float bestSoFar) {
+			const int dimensions = this->getDimensions();
+			const float infinity = std::numeric_limits<float>::infinity();
+			const float normalisation = (float) std::max(aLength, bLength);
+			const float totalBestSoFar = bestSoFar * normalisation;
+			const int band = std::max(this->getBand(aLength), std::abs(aLength - bLength));
+
+			this->previousRow.assign(bLength + 1, infinity);
+			this->currentRow.assign(bLength + 1, infinity);
+			this->previousRow[0] = 0.0f;
+
+			for (int i = 1; i <= aLength; i++) {
+				const int begin = std::max(1, i - band);
+				const int end = std::min(bLength, i + band);
+				std::fill(this->currentRow.begin(), this->currentRow.end(), infinity);
+
+				float rowMinimum = infinity;
+				const float * aFrame = a + (i - 1) * dimensions;
+				for (int j = begin; j <= end; j++) {
+					float cost = squaredDistance(aFrame, b + (j - 1) * dimensions, dimensions);
+					float previous = std::min(std::min(this->previousRow[j], this->currentRow[j - 1]), this->previousRow[j - 1]);
+					float value = cost + previous;
+					this->currentRow[j] = value;
+					rowMinimum = std::min(rowMinimum, value);
+				}
+
+				if (rowMinimum > totalBestSoFar) {
+					return infinity;
+				}
+				std::swap(this->previousRow, this->currentRow);
+			}
+
+			return this->previousRow[bLength] / normalisation;
+		}
+
+		//----------
+		void GestureRecognizer::updateEnvelope(Template & gestureTemplate) {
+			const int dimensions = this->getDimensions();
+			const int length = gestureTemplate.length;
+			const int band = this->getBand(length);
+			gestureTemplate.upper.resize(length * dimensions);
+			gestureTemplate.lower.resize(length * dimensions);
+
+			for (int i = 0; i < length; i++) {
+				const int begin = std::max(0, i - band);
+				const int end = std::min(length - 1, i + band);
+				for (int d = 0; d < dimensions; d++) {
+					float upper = -std::numeric_limits<float>::infinity();
+					float lower = std::numeric_limits<float>::infinity();
+					for (int k = begin; k <= end; k++) {
+						float value = gestureTemplate.features[k * dimensions + d];
+						upper = std::max(upper, value);
+						lower = std::min(lower, value);
+					}
+					gestureTemplate.upper[i * dimensions + d] = upper;
+					gestureTemplate.lower[i * dimensions + d] = lower;
+				}
+			}
+		}
+
+		//----------
+		void GestureRecognizer::allocateStreams() {
+			const int dimensions = this->getDimensions();
+			for (auto & stream : this->streams) {
+				stream.features.assign(2 * this->maxTemplateLength * dimensions, 0.0f);
+				stream.trackingId = 0;
+				stream.count = 0;
+				stream.head = this->maxTemplateLength - 1;
+				stream.refractory = 0;
+			}
+			this->previousRow.reserve(this->maxTemplateLength + 1);
+			this->currentRow.reserve(this->maxTemplateLength + 1);
+		}
+
+		//----------
+		int GestureRecognizer::getBand(int length) const {
+			return std::max(1, (int) (this->bandRatio * length));
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Data/Body.h"
+
+#include <Kinect.h>
+#include <limits>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Recognises gestures by dynamic time warping of joint trajectories against recorded templates.
+		// Works purely on Data::Body, so templates can be recorded and tested without a sensor.
+		//
+		// Each frame, every template is compared against the latest frames of every body:
+		//	1. LB_Kim (first and last frames) and LB_Keogh (template envelope) lower bounds
+		//	   discard most templates without running DTW
+		//	2. DTW within a Sakoe-Chiba band abandons as soon as a row exceeds the best distance so far
+		//
+		// Trajectories are normalised by translating to an origin joint and scaling by the torso length,
+		// so templates transfer between people and positions in the room.
+		class GestureRecognizer {
+		public:
+			struct Template {
+				string name;
+				int length; // frames
+				float threshold; // maximum mean squared distance per frame for a match
+				vector<float> features; // length x dimensions
+				vector<float> upper; // envelope for LB_Keogh
+				vector<float> lower;
+			};
+
+			struct Match {
+				int body;
+				UINT64 trackingId;
+				int templateIndex;
+				float distance;
+			};
+
+			struct Stats {
+				int comparisons = 0;
+				int prunedByKim = 0;
+				int prunedByKeogh = 0;
+				int abandonedDtw = 0;
+				float duration = 0.0f; // microseconds
+			};
+
+			GestureRecognizer();
+
+			// Joints forming the trajectory (default : hands, wrists and elbows)
+			void setJoints(const vector<JointType> &);
+			const vector<JointType> & getJoints() const;
+			int getDimensions() const;
+
+			// Width of the warping band as a fraction of template length
+			void setBandRatio(float);
+			// Frames to wait after a match before the same body can match again
+			void setRefractoryFrames(int);
+
+			// Record a template from consecutive frames of one body. Returns the template index.
+			int addTemplate(const string & name, const vector<Data::Body> & frames, float threshold);
+			int addTemplate(const string & name, const vector<float> & features, float threshold);
+			const vector<Template> & getTemplates() const;
+			void clearTemplates();
+
+			// Feed one frame for all bodies. Returns matches found on this frame.
+			const vector<Match> & update(const vector<Data::Body> &);
+			const vector<Match> & getMatches() const;
+			const Stats & getStats() const;
+
+			void reset();
+
+			// Normalised features of one body (getDimensions() floats). Returns false if the body can't be normalised.
+			bool computeFeatures(const Data::Body &, float * features) const;
+
+			// Banded DTW between two sequences of the same dimensions, as mean squared distance per frame.
+			// Abandons and returns infinity once the distance must exceed bestSoFar.
+			float dtw(const float * a, int aLength, const float * b, int bLength, float bestSoFar = std::numeric_limits<float>::infinity());
+		protected:
+			struct Stream {
+				UINT64 trackingId = 0;
+				int count = 0;
+				int head = 0;
+				int refractory = 0;
+				vector<float> features; // 2 x capacity frames, each frame written twice so any window is contiguous
+			};
+
+			void updateEnvelope(Template &);
+			void allocateStreams();
+			int getBand(int length) const;
+
+			vector<JointType> joints;
+			float bandRatio;
+			int refractoryFrames;
+
+			vector<Template> templates;
+			int maxTemplateLength;
+
+			Stream streams[BODY_COUNT];
+			vector<Match> matches;
+			Stats stats;
+
+			// DTW scratch rows
+			vector<float> previousRow;
+			vector<float> currentRow;
+		};
+	}
+}
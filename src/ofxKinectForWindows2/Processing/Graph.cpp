@@ -0,0 +1,237 @@
+#include "Graph.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		Graph::Graph(Threading::WorkStealingPool & pool) :
+			pool(pool) {
+			this->maxFramesInFlight = 3;
+			this->submittedFrameCount = 0;
+			this->droppedFrameCount = 0;
+			this->framesInFlight = 0;
+		}
+
+		//----------
+		Graph::~Graph() {
+			this->waitIdle();
+		}
+
+		//----------
+		int Graph::addNode(const std::string & name, const Function & function, const std::vector<int> & inputs) {
+			const int index = (int) this->nodes.size();
+			auto node = std::unique_ptr<Node>(new Node());
+			node->name = name;
+			node->function = function;
+			node->inputs = inputs;
+			for (auto input : inputs) {
+				this->nodes[input]->successors.push_back(index);
+			}
+			this->nodes.push_back(std::move(node));
+			this->inputValues.push_back(Value());
+			return index;
+		}
+
+		//----------
+		void Graph::setInputValue(int node, const Value & value) {
+			this->inputValues[node] = value;
+		}
+
+		//----------
+		Graph::Value Graph::getLatestValue(int node) const {
+			std::lock_guard<std::mutex> lock(this->nodes[node]->mutex);
+			return this->nodes[node]->latest;
+		}
+
+		//----------
+		bool Graph::submit() {
+			{
+				std::lock_guard<std::mutex> lock(this->framesMutex);
+				if (this->framesInFlight >= this->maxFramesInFlight) {
+					this->droppedFrameCount++;
+					return false;
+				}
+				this->framesInFlight++;
+			}
+
+			const int nodeCount = (int) this->nodes.size();
+			auto frame = std::make_shared<FrameState>();
+			frame->sequence = this->submittedFrameCount++;
+			frame->values.resize(nodeCount);
+			frame->waitingInputs.reset(new std::atomic<int>[nodeCount]);
+			frame->remainingNodes = nodeCount + 1; // held until all the starting nodes are out
+			for (int i = 0; i < nodeCount; i++) {
+				frame->waitingInputs[i] = (int) this->nodes[i]->inputs.size();
+			}
+
+			for (int i = 0; i < nodeCount; i++) {
+				auto & node = *this->nodes[i];
+				if (!node.function) {
+					frame->values[i] = this->inputValues[i];
+					{
+						std::lock_guard<std::mutex> lock(node.mutex);
+						node.latest = this->inputValues[i];
+					}
+					this->nodeFinished(i, frame);
+				}
+				else if (node.inputs.empty()) {
+					this->nodeReady(i, frame);
+				}
+			}
+			for (auto & value : this->inputValues) {
+				value.reset();
+			}
+
+			if (--frame->remainingNodes == 0) {
+				std::lock_guard<std::mutex> lock(this->framesMutex);
+				this->framesInFlight--;
+				this->framesIdle.notify_all();
+			}
+			return true;
+		}
+
+		//----------
+		void Graph::waitIdle() {
+			std::unique_lock<std::mutex> lock(this->framesMutex);
+			this->framesIdle.wait(lock, [this] { return this->framesInFlight == 0; });
+		}
+
+		//----------
+		void Graph::setMaxFramesInFlight(int maxFramesInFlight) {
+			std::lock_guard<std::mutex> lock(this->framesMutex);
+			this->maxFramesInFlight = std::max(maxFramesInFlight, 1);
+		}
+
+		//----------
+		int Graph::getMaxFramesInFlight() const {
+			std::lock_guard<std::mutex> lock(this->framesMutex);
+			return this->maxFramesInFlight;
+		}
+
+		//----------
+		int Graph::getFramesInFlight() const {
+			std::lock_guard<std::mutex> lock(this->framesMutex);
+			return this->framesInFlight;
+		}
+
+		//----------
+		uint64_t Graph::getSubmittedFrameCount() const {
+			return this->submittedFrameCount;
+		}
+
+		//----------
+		uint64_t Graph::getDroppedFrameCount() const {
+			std::lock_guard<std::mutex> lock(this->framesMutex);
+			return this->droppedFrameCount;
+		}
+
+		//----------
+		std::vector<Graph::NodeStatistics> Graph::getStatistics() const {
+			std::vector<NodeStatistics> statistics;
+			for (const auto & node : this->nodes) {
+				if (!node->function) {
+					continue;
+				}
+				std::lock_guard<std::mutex> lock(node->mutex);
+				NodeStatistics nodeStatistics;
+				nodeStatistics.name = node->name;
+				nodeStatistics.runCount = node->runCount;
+				nodeStatistics.skipCount = node->skipCount;
+				nodeStatistics.lastMilliseconds = node->lastMilliseconds;
+				nodeStatistics.averageMilliseconds = node->runCount > 0 ? node->totalMilliseconds / node->runCount : 0.0;
+				nodeStatistics.maxMilliseconds = node->maxMilliseconds;
+				nodeStatistics.queueDepth = (int) node->ready.size();
+				statistics.push_back(nodeStatistics);
+			}
+			return statistics;
+		}
+
+		//----------
+		void Graph::nodeReady(int index, const std::shared_ptr<FrameState> & frame) {
+			auto & node = *this->nodes[index];
+			std::lock_guard<std::mutex> lock(node.mutex);
+			node.ready.emplace(frame->sequence, frame);
+			this->startNext(node, index);
+		}
+
+		//----------
+		void Graph::startNext(Node & node, int index) {
+			//called with node.mutex held. Every frame passes every node, so sequences have no gaps
+			if (node.running || node.ready.empty() || node.ready.begin()->first != node.nextSequence) {
+				return;
+			}
+			auto frame = std::move(node.ready.begin()->second);
+			node.ready.erase(node.ready.begin());
+			node.running = true;
+			this->pool.submit([this, index, frame]() {
+				this->run(index, frame);
+			});
+		}
+
+		//----------
+		void Graph::run(int index, std::shared_ptr<FrameState> frame) {
+			auto & node = *this->nodes[index];
+
+			std::vector<Value> inputs;
+			inputs.reserve(node.inputs.size());
+			bool missingInput = false;
+			for (auto input : node.inputs) {
+				inputs.push_back(frame->values[input]);
+				missingInput |= !inputs.back();
+			}
+
+			Value output;
+			bool ran = false;
+			double milliseconds = 0.0;
+			if (!missingInput) {
+				const auto start = std::chrono::steady_clock::now();
+				try {
+					output = node.function(inputs.data());
+					ran = true;
+				}
+				catch (std::exception & e) {
+					OFXKINECTFORWINDOWS2_ERROR << node.name << " : " << e.what();
+				}
+				milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+			frame->values[index] = output;
+
+			{
+				std::lock_guard<std::mutex> lock(node.mutex);
+				if (ran) {
+					node.runCount++;
+					node.lastMilliseconds = milliseconds;
+					node.totalMilliseconds += milliseconds;
+					node.maxMilliseconds = std::max(node.maxMilliseconds, milliseconds);
+					if (output) {
+						node.latest = output;
+					}
+				}
+				else {
+					node.skipCount++;
+				}
+				node.running = false;
+				node.nextSequence++;
+				this->startNext(node, index);
+			}
+
+			this->nodeFinished(index, frame);
+		}
+
+		//----------
+		void Graph::nodeFinished(int index, const std::shared_ptr<FrameState> & frame) {
+			for (auto successor : this->nodes[index]->successors) {
+				if (--frame->waitingInputs[successor] == 0) {
+					this->nodeReady(successor, frame);
+				}
+			}
+			if (--frame->remainingNodes == 0) {
+				std::lock_guard<std::mutex> lock(this->framesMutex);
+				this->framesInFlight--;
+				this->framesIdle.notify_all();
+			}
+		}
+	}
+}
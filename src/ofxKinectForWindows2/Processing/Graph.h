@@ -0,0 +1,164 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Threading/WorkStealingPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Per frame processing (e.g. filter -> background subtraction -> blobs -> tracking -> send) as a graph of nodes
+		// run on a WorkStealingPool. Nodes of the same frame which don't depend on each other run in parallel, and
+		// consecutive frames overlap : frame n + 1 can be in the first nodes while frame n is in the last ones.
+		// A node runs one frame at a time and in frame order, so it may keep state between frames (e.g. a tracker).
+		// Add all the nodes before the first submit().
+		class Graph {
+		public:
+			// Output of a node, carrying the type of its value
+			template<typename T>
+			struct Port {
+				int node;
+			};
+
+			struct NodeStatistics {
+				std::string name;
+				uint64_t runCount;
+				uint64_t skipCount; // frames where the node threw, or an input was missing because an earlier node did
+				double lastMilliseconds;
+				double averageMilliseconds;
+				double maxMilliseconds;
+				int queueDepth; // frames ready for this node, waiting for it to finish an earlier frame
+			};
+
+			Graph(Threading::WorkStealingPool & = Threading::WorkStealingPool::getDefault());
+			// Waits for the frames in flight
+			~Graph();
+
+			// Value given for each frame with setInput()
+			template<typename T>
+			Port<T> addInput(const std::string & name) {
+				return Port<T> { this->addNode(name, nullptr, std::vector<int>()) };
+			}
+
+			// function is called with the values of the inputs (const In &...). It returns the value of the output,
+			// or nothing for nodes at the end of the graph.
+			template<typename Function, typename... In>
+			Port<typename std::decay<typename std::result_of<Function(const In &...)>::type>::type> addNode(const std::string & name, Function function, Port<In>... inputs) {
+				typedef typename std::decay<typename std::result_of<Function(const In &...)>::type>::type Out;
+				auto call = [function](const Value * values) mutable {
+					return Call<Out>::template call<Function, In...>(function, values, std::index_sequence_for<In...>());
+				};
+				return Port<Out> { this->addNode(name, call, std::vector<int> { inputs.node... }) };
+			}
+
+			template<typename T>
+			void setInput(const Port<T> & port, const T & value) {
+				this->setInputValue(port.node, std::make_shared<T>(value));
+			}
+
+			// Without copying, e.g. frames from Source::BaseImage::getFrame()
+			template<typename T>
+			void setInput(const Port<T> & port, const std::shared_ptr<const T> & value) {
+				this->setInputValue(port.node, value);
+			}
+
+			// Starts a frame with the values set since the last submit(). Returns false and drops the frame if
+			// maxFramesInFlight frames are still being processed.
+			bool submit();
+			void waitIdle();
+
+			// Value of the latest frame which got through this node, or nullptr
+			template<typename T>
+			std::shared_ptr<const T> getLatest(const Port<T> & port) const {
+				return std::static_pointer_cast<const T>(this->getLatestValue(port.node));
+			}
+
+			void setMaxFramesInFlight(int);
+			int getMaxFramesInFlight() const;
+			int getFramesInFlight() const;
+			uint64_t getSubmittedFrameCount() const;
+			uint64_t getDroppedFrameCount() const;
+
+			// One entry per node (inputs excluded), in the order they were added
+			std::vector<NodeStatistics> getStatistics() const;
+		protected:
+			typedef std::shared_ptr<const void> Value;
+			typedef std::function<Value(const Value *)> Function;
+
+			struct FrameState;
+
+			struct Node {
+				std::string name;
+				Function function; // empty for inputs
+				std::vector<int> inputs;
+				std::vector<int> successors;
+
+				mutable std::mutex mutex;
+				uint64_t nextSequence = 0;
+				std::map<uint64_t, std::shared_ptr<FrameState>> ready;
+				bool running = false;
+				Value latest;
+
+				uint64_t runCount = 0;
+				uint64_t skipCount = 0;
+				double lastMilliseconds = 0.0;
+				double totalMilliseconds = 0.0;
+				double maxMilliseconds = 0.0;
+			};
+
+			struct FrameState {
+				uint64_t sequence;
+				std::vector<Value> values;
+				std::unique_ptr<std::atomic<int>[]> waitingInputs;
+				std::atomic<int> remainingNodes;
+			};
+
+			template<typename Out, typename Unused = void>
+			struct Call {
+				template<typename Function, typename... In, size_t... I>
+				static Value call(Function & function, const Value * values, std::index_sequence<I...>) {
+					return std::make_shared<Out>(function(*std::static_pointer_cast<const In>(values[I])...));
+				}
+			};
+
+			template<typename Unused>
+			struct Call<void, Unused> {
+				template<typename Function, typename... In, size_t... I>
+				static Value call(Function & function, const Value * values, std::index_sequence<I...>) {
+					function(*std::static_pointer_cast<const In>(values[I])...);
+					return Value();
+				}
+			};
+
+			int addNode(const std::string & name, const Function &, const std::vector<int> & inputs);
+			void setInputValue(int node, const Value &);
+			Value getLatestValue(int node) const;
+
+			// Queues the frame on the node, and starts the node if this is the frame it expects next
+			void nodeReady(int node, const std::shared_ptr<FrameState> &);
+			void startNext(Node &, int node);
+			void run(int node, std::shared_ptr<FrameState>);
+			void nodeFinished(int node, const std::shared_ptr<FrameState> &);
+
+			Threading::WorkStealingPool & pool;
+			std::vector<std::unique_ptr<Node>> nodes;
+			std::vector<Value> inputValues;
+
+			int maxFramesInFlight;
+			uint64_t submittedFrameCount;
+			uint64_t droppedFrameCount;
+
+			mutable std::mutex framesMutex;
+			std::condition_variable framesIdle;
+			int framesInFlight;
+		};
+	}
+}
@@ -0,0 +1,222 @@
+#include "Greenscreen.h"
+#include "../Threading/ThreadPool.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		Greenscreen::Greenscreen() {
+			this->featherRadius = 2;
+			this->bodyMask = (1 << BODY_COUNT) - 1;
+			this->bandCount = 32;
+		}
+
+		//----------
+		bool Greenscreen::update(const Source::Depth & depth, const Source::BodyIndex & bodyIndex, const Source::Color & color) {
+			return this->update(depth.getPixels(), bodyIndex.getPixels(), color.getPixels(), depth.getCoordinateMapper());
+		}
+
+		//----------
+		bool Greenscreen::update(const ofShortPixels & depth, const ofPixels & bodyIndex, const ofPixels & color, ICoordinateMapper * coordinateMapper) {
+			if (!depth.isAllocated() || !bodyIndex.isAllocated() || !color.isAllocated() || !coordinateMapper) {
+				return false;
+			}
+
+			const int depthWidth = (int) depth.getWidth();
+			const int depthHeight = (int) depth.getHeight();
+			if (bodyIndex.getWidth() != depthWidth || bodyIndex.getHeight() != depthHeight) {
+				OFXKINECTFORWINDOWS2_ERROR << "Depth and BodyIndex frames have different sizes";
+				return false;
+			}
+
+			if (color.getNumChannels() != 4) {
+				OFXKINECTFORWINDOWS2_ERROR << "Greenscreen expects RGBA color pixels";
+				return false;
+			}
+			const int width = (int) color.getWidth();
+			const int height = (int) color.getHeight();
+			const int colorSize = width * height;
+
+			if (this->matte.getWidth() != width || this->matte.getHeight() != height) {
+				this->matte.allocate(width, height, OF_IMAGE_GRAYSCALE);
+			}
+			if (this->pixels.getWidth() != width || this->pixels.getHeight() != height) {
+				this->pixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+			}
+
+			auto & pool = Threading::ThreadPool::getDefault();
+			const int requestedBandCount = std::min(this->bandCount, height);
+			const int rowsPerBand = (height + requestedBandCount - 1) / requestedBandCount;
+			//rounding up the band height can leave fewer bands than asked for
+			const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+			const unsigned char * bodyIndexData = bodyIndex.getData();
+			const unsigned char bodyMask = this->bodyMask;
+
+			//MapColorFrameToDepthSpace is one serial SDK call over the whole frame and is most of our cost,
+			//so skip it while none of the bodies we keep are in view
+			const int depthSize = depthWidth * depthHeight;
+			bool anyBody = false;
+			for (int i = 0; i < depthSize && !anyBody; i++) {
+				const unsigned char index = bodyIndexData[i];
+				anyBody = index < BODY_COUNT && (bodyMask & (1 << index));
+			}
+
+			if (anyBody) {
+				this->depthSpacePoints.resize(colorSize);
+				if (FAILED(coordinateMapper->MapColorFrameToDepthSpace(depth.size(), depth.getData(), colorSize, this->depthSpacePoints.data()))) {
+					OFXKINECTFORWINDOWS2_ERROR << "MapColorFrameToDepthSpace failed";
+					return false;
+				}
+			}
+
+			//matte
+			pool.parallelFor(bandCount, [&](int band) {
+				const int begin = band * rowsPerBand * width;
+				const int end = std::min(begin + rowsPerBand * width, colorSize);
+				const DepthSpacePoint * points = this->depthSpacePoints.data();
+				unsigned char * matte = this->matte.getData();
+				if (!anyBody) {
+					memset(matte + begin, 0, end - begin);
+					return;
+				}
+				for (int i = begin; i < end; i++) {
+					const auto & point = points[i];
+					unsigned char alpha = 0;
+					//unmappable points are -infinity, which fails these tests
+					if (point.X >= 0.0f && point.X < depthWidth - 0.5f && point.Y >= 0.0f && point.Y < depthHeight - 0.5f) {
+						const int x = (int) (point.X + 0.5f);
+						const int y = (int) (point.Y + 0.5f);
+						const unsigned char index = bodyIndexData[y * depthWidth + x];
+						if (index < BODY_COUNT && (bodyMask & (1 << index))) {
+							alpha = 255;
+						}
+					}
+					matte[i] = alpha;
+				}
+			});
+
+			if (anyBody && this->featherRadius > 0) {
+				this->feather(width, height, bandCount);
+			}
+
+			//composite
+			pool.parallelFor(bandCount, [&](int band) {
+				const int begin = band * rowsPerBand * width;
+				const int end = std::min(begin + rowsPerBand * width, colorSize);
+				const unsigned char * matte = this->matte.getData();
+				const unsigned char * input = color.getData();
+				unsigned char * output = this->pixels.getData();
+				memcpy(output + begin * 4, input + begin * 4, (end - begin) * 4);
+				for (int i = begin; i < end; i++) {
+					output[i * 4 + 3] = matte[i];
+				}
+			});
+
+			return true;
+		}
+
+		//----------
+		void Greenscreen::setFeatherRadius(int featherRadius) {
+			this->featherRadius = std::max(featherRadius, 0);
+		}
+
+		//----------
+		int Greenscreen::getFeatherRadius() const {
+			return this->featherRadius;
+		}
+
+		//----------
+		void Greenscreen::setBodyMask(unsigned char bodyMask) {
+			this->bodyMask = bodyMask;
+		}
+
+		//----------
+		unsigned char Greenscreen::getBodyMask() const {
+			return this->bodyMask;
+		}
+
+		//----------
+		void Greenscreen::setBandCount(int bandCount) {
+			this->bandCount = std::max(bandCount, 1);
+		}
+
+		//----------
+		const ofPixels & Greenscreen::getPixels() const {
+			return this->pixels;
+		}
+
+		//----------
+		const ofPixels & Greenscreen::getMatte() const {
+			return this->matte;
+		}
+
+		//----------
+		void Greenscreen::feather(int width, int height, int bandCount) {
+			//separable box blur with running sums, edges clamped
+			//radius is capped so the fixed point normalisation of a full window stays at 255
+			const int radius = std::min(std::min(this->featherRadius, 63), std::min(width, height) / 2);
+			const int diameter = 2 * radius + 1;
+			const unsigned int scale = (1 << 16) / diameter;
+			auto & pool = Threading::ThreadPool::getDefault();
+
+			if (this->featherBuffer.getWidth() != width || this->featherBuffer.getHeight() != height) {
+				this->featherBuffer.allocate(width, height, OF_IMAGE_GRAYSCALE);
+			}
+			//running column sums, each band works in its own slice
+			this->featherSums.resize(width);
+
+			//horizontal, matte -> buffer
+			const int rowsPerBand = (height + bandCount - 1) / bandCount;
+			pool.parallelFor(bandCount, [&](int band) {
+				const int begin = band * rowsPerBand;
+				const int end = std::min(begin + rowsPerBand, height);
+				for (int y = begin; y < end; y++) {
+					const unsigned char * input = this->matte.getData() + y * width;
+					unsigned char * output = this->featherBuffer.getData() + y * width;
+
+					unsigned int sum = input[0] * (radius + 1);
+					for (int x = 1; x <= radius; x++) {
+						sum += input[x];
+					}
+					for (int x = 0; x < width; x++) {
+						output[x] = (unsigned char) ((sum * scale + (1 << 15)) >> 16);
+						sum += input[std::min(x + radius + 1, width - 1)];
+						sum -= input[std::max(x - radius, 0)];
+					}
+				}
+			});
+
+			//vertical, buffer -> matte. Bands of columns, walking down the rows to stay cache friendly
+			const int columnsPerBand = (width + bandCount - 1) / bandCount;
+			pool.parallelFor(bandCount, [&](int band) {
+				const int begin = band * columnsPerBand;
+				const int end = std::min(begin + columnsPerBand, width);
+				if (begin >= end) {
+					return;
+				}
+				const unsigned char * input = this->featherBuffer.getData();
+				unsigned char * output = this->matte.getData();
+				unsigned int * sums = this->featherSums.data();
+
+				for (int x = begin; x < end; x++) {
+					unsigned int sum = input[x] * (radius + 1);
+					for (int y = 1; y <= radius; y++) {
+						sum += input[y * width + x];
+					}
+					sums[x] = sum;
+				}
+				for (int y = 0; y < height; y++) {
+					const unsigned char * added = input + std::min(y + radius + 1, height - 1) * width;
+					const unsigned char * removed = input + std::max(y - radius, 0) * width;
+					unsigned char * outputRow = output + y * width;
+					for (int x = begin; x < end; x++) {
+						unsigned int & sum = sums[x];
+						outputRow[x] = (unsigned char) ((sum * scale + (1 << 15)) >> 16);
+						sum += added[x];
+						sum -= removed[x];
+					}
+				}
+			});
+		}
+	}
+}
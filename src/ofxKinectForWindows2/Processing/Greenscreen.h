@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Source/Depth.h"
+#include "../Source/BodyIndex.h"
+#include "../Source/Color.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Cuts tracked bodies out of the color frame at full color resolution.
+		// Every color pixel is mapped into depth space (MapColorFrameToDepthSpace) and takes its alpha
+		// from the BodyIndex pixel it lands on, so edges follow the color image rather than
+		// blocky depth pixels. Matte, feathering and composite run in parallel row bands.
+		class Greenscreen {
+		public:
+			Greenscreen();
+
+			// Returns false if the frames aren't available or don't match. Both the matte and the
+			// composite are made at the resolution of the color frame, so there is nothing to do without one.
+			bool update(const Source::Depth &, const Source::BodyIndex &, const Source::Color &);
+			bool update(const ofShortPixels & depth, const ofPixels & bodyIndex, const ofPixels & color, ICoordinateMapper *);
+
+			// Blur radius of the matte edge in color pixels (0 for a hard edge)
+			void setFeatherRadius(int);
+			int getFeatherRadius() const;
+
+			// Bit b set keeps body index b (default : all bodies)
+			void setBodyMask(unsigned char);
+			unsigned char getBodyMask() const;
+
+			void setBandCount(int);
+
+			// Color with the matte in the alpha channel
+			const ofPixels & getPixels() const;
+			// Single channel matte
+			const ofPixels & getMatte() const;
+		protected:
+			void feather(int width, int height, int bandCount);
+
+			int featherRadius;
+			unsigned char bodyMask;
+			int bandCount;
+
+			vector<DepthSpacePoint> depthSpacePoints;
+			ofPixels matte;
+			ofPixels featherBuffer;
+			vector<unsigned int> featherSums;
+			ofPixels pixels;
+		};
+	}
+}
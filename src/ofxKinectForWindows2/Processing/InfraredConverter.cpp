@@ -0,0 +1,192 @@
+#include "InfraredConverter.h"
+#include "ofMain.h"
+
+// histogram bins are the top 10 bits of the 16 bit value
+#define INFRARED_HISTOGRAM_SHIFT 6
+#define INFRARED_HISTOGRAM_BINS (65536 >> INFRARED_HISTOGRAM_SHIFT)
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		InfraredConverter::InfraredConverter() {
+			this->mode = Raw;
+			this->low = 0;
+			this->high = 8192;
+			this->lowPercentile = 0.01f;
+			this->highPercentile = 0.99f;
+			this->percentileSmoothing = 0.5f;
+			this->percentileLow = this->low;
+			this->percentileHigh = this->high;
+			this->smoothedLow = 0.0f;
+			this->smoothedHigh = 0.0f;
+			this->smoothedRangeValid = false;
+			this->gamma = 0.5f;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		void InfraredConverter::setMode(Mode mode) {
+			this->mode = mode;
+			this->smoothedRangeValid = false;
+		}
+
+		//----------
+		InfraredConverter::Mode InfraredConverter::getMode() const {
+			return this->mode;
+		}
+
+		//----------
+		void InfraredConverter::setRange(unsigned short low, unsigned short high) {
+			if (high <= low) {
+				OFXKINECTFORWINDOWS2_WARNING << "Infrared range must have high > low";
+				high = low + 1;
+			}
+			this->low = low;
+			this->high = high;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		unsigned short InfraredConverter::getLow() const {
+			return this->low;
+		}
+
+		//----------
+		unsigned short InfraredConverter::getHigh() const {
+			return this->high;
+		}
+
+		//----------
+		void InfraredConverter::setPercentiles(float low, float high) {
+			this->lowPercentile = ofClamp(low, 0.0f, 1.0f);
+			this->highPercentile = ofClamp(high, this->lowPercentile, 1.0f);
+		}
+
+		//----------
+		void InfraredConverter::setPercentileSmoothing(float percentileSmoothing) {
+			this->percentileSmoothing = ofClamp(percentileSmoothing, 0.0f, 0.99f);
+		}
+
+		//----------
+		unsigned short InfraredConverter::getPercentileLow() const {
+			return this->percentileLow;
+		}
+
+		//----------
+		unsigned short InfraredConverter::getPercentileHigh() const {
+			return this->percentileHigh;
+		}
+
+		//----------
+		void InfraredConverter::setGamma(float gamma) {
+			this->gamma = gamma;
+			this->lookupTableDirty = true;
+		}
+
+		//----------
+		float InfraredConverter::getGamma() const {
+			return this->gamma;
+		}
+
+		//----------
+		bool InfraredConverter::convert(const ofShortPixels & input, ofPixels & output) {
+			if (this->mode == Raw || !input.isAllocated()) {
+				return false;
+			}
+			if (output.getWidth() != input.getWidth() || output.getHeight() != input.getHeight() || output.getNumChannels() != 1) {
+				output.allocate(input.getWidth(), input.getHeight(), OF_IMAGE_GRAYSCALE);
+			}
+
+			const unsigned short * in = input.getData();
+			unsigned char * out = output.getData();
+			const size_t count = input.getWidth() * input.getHeight();
+
+			if (this->mode == Gamma) {
+				if (this->lookupTableDirty) {
+					this->updateLookupTable();
+				}
+				const unsigned char * lookupTable = this->lookupTable.data();
+				for (size_t i = 0; i < count; i++) {
+					out[i] = lookupTable[in[i]];
+				}
+				return true;
+			}
+
+			unsigned int low = this->low;
+			unsigned int high = this->high;
+			if (this->mode == Percentile) {
+				this->updatePercentileRange(input);
+				low = this->percentileLow;
+				high = this->percentileHigh;
+			}
+
+			//out = (clamp(in, low, high) - low) * 255 / (high - low), in 16.16 fixed point, rounded so that high gives 255.
+			//no branches or lookups so the compiler can vectorize this loop
+			const unsigned int range = high - low;
+			const unsigned int scale = ((255u << 16) + range / 2) / range;
+			for (size_t i = 0; i < count; i++) {
+				unsigned int value = in[i];
+				value = value > low ? value - low : 0;
+				value = value < range ? value : range;
+				out[i] = (unsigned char) ((value * scale + 0x8000) >> 16);
+			}
+			return true;
+		}
+
+		//----------
+		void InfraredConverter::updatePercentileRange(const ofShortPixels & input) {
+			this->histogram.assign(INFRARED_HISTOGRAM_BINS, 0);
+			const unsigned short * in = input.getData();
+			const size_t count = input.getWidth() * input.getHeight();
+
+			//every 4th pixel is plenty for percentiles
+			const size_t step = 4;
+			for (size_t i = 0; i < count; i += step) {
+				this->histogram[in[i] >> INFRARED_HISTOGRAM_SHIFT]++;
+			}
+			const unsigned int samples = (unsigned int) ((count + step - 1) / step);
+			const unsigned int lowCount = (unsigned int) (this->lowPercentile * samples);
+			const unsigned int highCount = (unsigned int) (this->highPercentile * samples);
+
+			int lowBin = 0, highBin = INFRARED_HISTOGRAM_BINS - 1;
+			unsigned int accumulated = 0;
+			bool lowFound = false;
+			for (int bin = 0; bin < INFRARED_HISTOGRAM_BINS; bin++) {
+				accumulated += this->histogram[bin];
+				if (!lowFound && accumulated > lowCount) {
+					lowBin = bin;
+					lowFound = true;
+				}
+				if (accumulated >= highCount) {
+					highBin = bin;
+					break;
+				}
+			}
+
+			float low = (float) (lowBin << INFRARED_HISTOGRAM_SHIFT);
+			float high = (float) ((highBin + 1) << INFRARED_HISTOGRAM_SHIFT);
+			if (this->smoothedRangeValid) {
+				low = ofLerp(low, this->smoothedLow, this->percentileSmoothing);
+				high = ofLerp(high, this->smoothedHigh, this->percentileSmoothing);
+			}
+			this->smoothedLow = low;
+			this->smoothedHigh = high;
+			this->smoothedRangeValid = true;
+
+			this->percentileLow = (unsigned short) ofClamp(low, 0.0f, 65534.0f);
+			this->percentileHigh = (unsigned short) ofClamp(high, this->percentileLow + 1.0f, 65535.0f);
+		}
+
+		//----------
+		void InfraredConverter::updateLookupTable() {
+			this->lookupTable.resize(65536);
+			const float low = this->low;
+			const float range = (float) (this->high - this->low);
+			for (int i = 0; i < 65536; i++) {
+				float normalized = ofClamp((i - low) / range, 0.0f, 1.0f);
+				this->lookupTable[i] = (unsigned char) (pow(normalized, this->gamma) * 255.0f + 0.5f);
+			}
+			this->lookupTableDirty = false;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../Utils.h"
+
+#include "ofPixels.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Converts 16 bit infrared frames to viewable 8 bit pixels in a single pass.
+		//	FixedRange : linear from [low, high] to [0, 255]
+		//	Percentile : as FixedRange, with low and high found per frame from a coarse histogram
+		//	Gamma : [low, high] through a gamma curve, using a 64K entry lookup table built when settings change
+		class InfraredConverter {
+		public:
+			enum Mode {
+				Raw, // no conversion
+				FixedRange,
+				Percentile,
+				Gamma
+			};
+
+			InfraredConverter();
+
+			void setMode(Mode);
+			Mode getMode() const;
+
+			void setRange(unsigned short low, unsigned short high);
+			unsigned short getLow() const;
+			unsigned short getHigh() const;
+
+			// Fractions of pixels clipped to black and to white in Percentile mode
+			void setPercentiles(float low, float high);
+			// 0 follows each frame's range, towards 1 the range changes more slowly (avoids flicker)
+			void setPercentileSmoothing(float);
+			// Range found for the latest frame in Percentile mode (setRange is left as it was)
+			unsigned short getPercentileLow() const;
+			unsigned short getPercentileHigh() const;
+
+			void setGamma(float);
+			float getGamma() const;
+
+			// Returns false in Raw mode
+			bool convert(const ofShortPixels & input, ofPixels & output);
+		protected:
+			void updatePercentileRange(const ofShortPixels &);
+			void updateLookupTable();
+
+			Mode mode;
+			unsigned short low;
+			unsigned short high;
+			float lowPercentile;
+			float highPercentile;
+			float percentileSmoothing;
+			unsigned short percentileLow;
+			unsigned short percentileHigh;
+			float smoothedLow;
+			float smoothedHigh;
+			bool smoothedRangeValid;
+			float gamma;
+
+			vector<unsigned int> histogram;
+			vector<unsigned char> lookupTable;
+			bool lookupTableDirty;
+		};
+	}
+}
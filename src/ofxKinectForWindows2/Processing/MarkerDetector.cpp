@@ -0,0 +1,277 @@
+#include "MarkerDetector.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		//----------
+		MarkerDetector::MarkerDetector() {
+			this->threshold = 20000;
+			this->minimumArea = 2;
+			this->maximumArea = 2000;
+			this->maxMarkers = 64;
+			this->maxRuns = 16384;
+
+			this->runs.reserve(this->maxRuns);
+			this->components.reserve(this->maxRuns);
+			this->componentOfRoot.reserve(this->maxRuns);
+			this->markers.reserve(this->maxMarkers);
+		}
+
+		//----------
+		void MarkerDetector::setThreshold(unsigned short threshold) {
+			this->threshold = threshold;
+		}
+
+		//----------
+		unsigned short MarkerDetector::getThreshold() const {
+			return this->threshold;
+		}
+
+		//----------
+		void MarkerDetector::setAreaRange(int minimum, int maximum) {
+			this->minimumArea = std::max(minimum, 1);
+			this->maximumArea = std::max(maximum, this->minimumArea);
+		}
+
+		//----------
+		void MarkerDetector::setMaxMarkers(int maxMarkers) {
+			this->maxMarkers = std::max(maxMarkers, 1);
+			this->markers.reserve(this->maxMarkers);
+		}
+
+		//----------
+		const vector<MarkerDetector::Marker> & MarkerDetector::update(const ofShortPixels & infrared) {
+			this->detect(infrared);
+			return this->markers;
+		}
+
+		//----------
+		const vector<MarkerDetector::Marker> & MarkerDetector::update(const ofShortPixels & infrared, const Source::Depth & depth) {
+			this->detect(infrared);
+
+			//without a local sensor there is no depth to world table, markers keep hasWorld false
+			const auto & depthPixels = depth.getPixels();
+			if (this->markers.empty() || !depth.getCoordinateMapper() || depthPixels.getWidth() != infrared.getWidth() || depthPixels.getHeight() != infrared.getHeight()) {
+				return this->markers;
+			}
+
+			//the table only depends on the sensor's intrinsics, so fetch it once
+			const size_t frameSize = depthPixels.getWidth() * depthPixels.getHeight();
+			if (this->depthToCameraTable.size() != frameSize) {
+				ofFloatPixels table;
+				depth.getDepthToWorldTable(table);
+				if (table.size() != frameSize * 2) {
+					return this->markers;
+				}
+				this->depthToCameraTable.resize(frameSize);
+				memcpy(this->depthToCameraTable.data(), table.getData(), frameSize * sizeof(PointF));
+			}
+
+			for (auto & marker : this->markers) {
+				marker.hasWorld = this->lift(marker, depthPixels);
+			}
+			return this->markers;
+		}
+
+		//----------
+		const vector<MarkerDetector::Marker> & MarkerDetector::getMarkers() const {
+			return this->markers;
+		}
+
+		//----------
+		int MarkerDetector::find(int run) {
+			while (this->runs[run].parent != run) {
+				//path halving
+				this->runs[run].parent = this->runs[this->runs[run].parent].parent;
+				run = this->runs[run].parent;
+			}
+			return run;
+		}
+
+		//----------
+		void MarkerDetector::unite(int a, int b) {
+			a = this->find(a);
+			b = this->find(b);
+			if (a != b) {
+				//keep the earlier run as root so roots are found in scan order
+				if (a < b) {
+					this->runs[b].parent = a;
+				}
+				else {
+					this->runs[a].parent = b;
+				}
+			}
+		}
+
+		//----------
+		void MarkerDetector::detect(const ofShortPixels & infrared) {
+			this->runs.clear();
+			this->components.clear();
+			this->markers.clear();
+			if (!infrared.isAllocated() || infrared.getNumChannels() != 1) {
+				return;
+			}
+
+			const int width = (int) infrared.getWidth();
+			const int height = (int) infrared.getHeight();
+			const unsigned short * data = infrared.getData();
+			const unsigned short threshold = this->threshold;
+			bool overflow = false;
+
+			//extract runs and join them to the overlapping runs of the previous row
+			int previousRowBegin = 0, previousRowEnd = 0;
+			for (int y = 0; y < height && !overflow; y++) {
+				const unsigned short * row = data + y * width;
+				const int rowBegin = (int) this->runs.size();
+				int previous = previousRowBegin;
+
+				for (int x = 0; x < width; x++) {
+					if (row[x] <= threshold) {
+						continue;
+					}
+					const int begin = x;
+					while (x < width && row[x] > threshold) {
+						x++;
+					}
+					if ((int) this->runs.size() == this->maxRuns) {
+						overflow = true;
+						break;
+					}
+
+					Run run;
+					run.y = y;
+					run.begin = begin;
+					run.end = x;
+					run.parent = (int) this->runs.size();
+					this->runs.push_back(run);
+
+					//8-connected : previous row runs overlapping [begin - 1, end]
+					while (previous < previousRowEnd && this->runs[previous].end < begin) {
+						previous++;
+					}
+					for (int p = previous; p < previousRowEnd && this->runs[p].begin <= x; p++) {
+						this->unite(p, run.parent);
+					}
+				}
+
+				previousRowBegin = rowBegin;
+				previousRowEnd = (int) this->runs.size();
+			}
+
+			if (overflow) {
+				OFXKINECTFORWINDOWS2_WARNING << "Too many bright runs, threshold may be too low";
+			}
+
+			//accumulate runs into their root's component
+			const int runCount = (int) this->runs.size();
+			this->componentOfRoot.assign(runCount, -1);
+			for (int r = 0; r < runCount; r++) {
+				const auto & run = this->runs[r];
+				const int root = this->find(r);
+				int & componentIndex = this->componentOfRoot[root];
+				if (componentIndex == -1) {
+					componentIndex = (int) this->components.size();
+					Component component;
+					component.area = 0;
+					component.sumWeight = component.sumWeightX = component.sumWeightY = 0.0;
+					component.minX = component.minY = std::numeric_limits<int>::max();
+					component.maxX = component.maxY = -1;
+					this->components.push_back(component);
+				}
+				auto & component = this->components[componentIndex];
+
+				const unsigned short * row = data + run.y * width;
+				double sumWeight = 0.0, sumWeightX = 0.0;
+				for (int x = run.begin; x < run.end; x++) {
+					const double weight = row[x] - threshold;
+					sumWeight += weight;
+					sumWeightX += weight * x;
+				}
+				component.area += run.end - run.begin;
+				component.sumWeight += sumWeight;
+				component.sumWeightX += sumWeightX;
+				component.sumWeightY += sumWeight * run.y;
+				component.minX = std::min(component.minX, run.begin);
+				component.maxX = std::max(component.maxX, run.end - 1);
+				component.minY = std::min(component.minY, run.y);
+				component.maxY = std::max(component.maxY, run.y);
+			}
+
+			//keep the maxMarkers brightest in a heap with the dimmest on top, so markers never grows past the capacity
+			//reserved in setMaxMarkers and each rejected component costs one comparison
+			auto byIntensity = [](const Marker & a, const Marker & b) {
+				return a.intensity > b.intensity;
+			};
+			for (const auto & component : this->components) {
+				if (component.area < this->minimumArea || component.area > this->maximumArea || component.sumWeight <= 0.0) {
+					continue;
+				}
+				const float intensity = (float) component.sumWeight;
+				const bool full = (int) this->markers.size() == this->maxMarkers;
+				if (full && intensity <= this->markers.front().intensity) {
+					continue;
+				}
+				Marker marker;
+				marker.position.set((float) (component.sumWeightX / component.sumWeight), (float) (component.sumWeightY / component.sumWeight));
+				marker.bounds.set(component.minX, component.minY, component.maxX - component.minX + 1, component.maxY - component.minY + 1);
+				marker.area = component.area;
+				marker.intensity = intensity;
+				marker.hasWorld = false;
+				if (full) {
+					std::pop_heap(this->markers.begin(), this->markers.end(), byIntensity);
+					this->markers.back() = marker;
+				}
+				else {
+					this->markers.push_back(marker);
+				}
+				std::push_heap(this->markers.begin(), this->markers.end(), byIntensity);
+			}
+			std::sort_heap(this->markers.begin(), this->markers.end(), byIntensity);
+		}
+
+		//----------
+		bool MarkerDetector::lift(Marker & marker, const ofShortPixels & depth) const {
+			const int width = (int) depth.getWidth();
+			const int height = (int) depth.getHeight();
+
+			//retroreflectors often saturate the depth sensor, so average the valid depth around the marker
+			const int margin = 2;
+			const int x0 = std::max((int) marker.bounds.x - margin, 0);
+			const int y0 = std::max((int) marker.bounds.y - margin, 0);
+			const int x1 = std::min((int) (marker.bounds.x + marker.bounds.width) + margin, width);
+			const int y1 = std::min((int) (marker.bounds.y + marker.bounds.height) + margin, height);
+			unsigned int sum = 0, count = 0;
+			for (int y = y0; y < y1; y++) {
+				const unsigned short * row = depth.getData() + y * width;
+				for (int x = x0; x < x1; x++) {
+					if (row[x] != 0) {
+						sum += row[x];
+						count++;
+					}
+				}
+			}
+			if (count == 0) {
+				return false;
+			}
+			const float z = (float) sum / (float) count * 0.001f;
+
+			//bilinear lookup of the camera ray at the sub-pixel centroid
+			const float fx = ofClamp(marker.position.x, 0.0f, width - 1.001f);
+			const float fy = ofClamp(marker.position.y, 0.0f, height - 1.001f);
+			const int ix = (int) fx;
+			const int iy = (int) fy;
+			const float ax = fx - ix;
+			const float ay = fy - iy;
+			const PointF * table = this->depthToCameraTable.data();
+			const PointF & p00 = table[iy * width + ix];
+			const PointF & p10 = table[iy * width + ix + 1];
+			const PointF & p01 = table[(iy + 1) * width + ix];
+			const PointF & p11 = table[(iy + 1) * width + ix + 1];
+			const float rayX = (p00.X * (1 - ax) + p10.X * ax) * (1 - ay) + (p01.X * (1 - ax) + p11.X * ax) * ay;
+			const float rayY = (p00.Y * (1 - ax) + p10.Y * ax) * (1 - ay) + (p01.Y * (1 - ax) + p11.Y * ax) * ay;
+
+			marker.world.set(rayX * z, rayY * z, z);
+			return true;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Source/Depth.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Finds bright (e.g. retroreflective) markers in the Infrared or LongExposureInfrared frame.
+		// Pixels above the threshold are grouped into 8-connected components in a single pass over
+		// runs of pixels, each with an intensity weighted sub-pixel centroid.
+		// Given the depth frame (same sensor, so same pixels), markers are also lifted to camera space.
+		// Buffers are sized once, so a frame never allocates (components beyond the limits are dropped).
+		class MarkerDetector {
+		public:
+			struct Marker {
+				ofVec2f position; // sub-pixel, infrared / depth frame pixels
+				ofRectangle bounds;
+				int area; // pixels
+				float intensity; // summed value above threshold
+				bool hasWorld;
+				ofVec3f world; // m, camera space
+			};
+
+			MarkerDetector();
+
+			void setThreshold(unsigned short);
+			unsigned short getThreshold() const;
+			// Components outside this area range (pixels) are ignored
+			void setAreaRange(int minimum, int maximum);
+			void setMaxMarkers(int);
+
+			// Returns the markers found in this frame, largest intensity first
+			const vector<Marker> & update(const ofShortPixels & infrared);
+			const vector<Marker> & update(const ofShortPixels & infrared, const Source::Depth &);
+
+			const vector<Marker> & getMarkers() const;
+		protected:
+			struct Run {
+				int y;
+				int begin; // first pixel
+				int end; // one past last pixel
+				int parent; // union find
+			};
+			struct Component {
+				int area;
+				double sumWeight;
+				double sumWeightX;
+				double sumWeightY;
+				int minX, minY, maxX, maxY;
+			};
+
+			int find(int run);
+			void unite(int a, int b);
+			void detect(const ofShortPixels & infrared);
+			bool lift(Marker &, const ofShortPixels & depth) const;
+
+			unsigned short threshold;
+			int minimumArea;
+			int maximumArea;
+			int maxMarkers;
+			int maxRuns;
+
+			vector<Run> runs;
+			vector<Component> components;
+			vector<int> componentOfRoot;
+			vector<Marker> markers;
+			vector<PointF> depthToCameraTable;
+		};
+	}
+}
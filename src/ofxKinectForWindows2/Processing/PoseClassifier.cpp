@@ -0,0 +1,510 @@
+#include "PoseClassifier.h"
+#include "ofMain.h"
+
+#include <limits>
+
+#define POSE_CLASSIFIER_LEAF_SIZE 8
+#define POSE_CLASSIFIER_VERSION 1
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+#pragma mark BinaryReader
+		namespace {
+		//----------
+		class BinaryReader {
+		public:
+			BinaryReader(const char * data, size_t size) : data(data), size(size), position(0) { }
+
+			template<typename T>
+			bool read(T * values, size_t count = 1) {
+				size_t bytes = sizeof(T) * count;
+				if (this->position + bytes > this->size) {
+					return false;
+				}
+				memcpy(values, this->data + this->position, bytes);
+				this->position += bytes;
+				return true;
+			}
+		protected:
+			const char * data;
+			size_t size;
+			size_t position;
+		};
+
+		//----------
+		template<typename T>
+		static void writeBinary(vector<char> & buffer, const T * values, size_t count = 1) {
+			const char * bytes = (const char *) values;
+			buffer.insert(buffer.end(), bytes, bytes + sizeof(T) * count);
+		}
+		}
+
+#pragma mark PoseClassifier
+		//----------
+		PoseClassifier::PoseClassifier() {
+			this->joints = {
+				JointType_Head, JointType_Neck, JointType_SpineMid, JointType_SpineBase,
+				JointType_ElbowLeft, JointType_WristLeft, JointType_HandLeft,
+				JointType_ElbowRight, JointType_WristRight, JointType_HandRight,
+				JointType_KneeLeft, JointType_AnkleLeft,
+				JointType_KneeRight, JointType_AnkleRight
+			};
+			this->includeOrientations = false;
+			this->k = 5;
+			this->maxDistance = 1.0f;
+			this->dirty = true;
+			this->results.resize(BODY_COUNT);
+		}
+
+		//----------
+		void PoseClassifier::setJoints(const vector<JointType> & joints, bool includeOrientations) {
+			if (!this->exampleLabels.empty()) {
+				OFXKINECTFORWINDOWS2_WARNING << "Changing joints clears all examples";
+			}
+			this->joints = joints;
+			this->includeOrientations = includeOrientations;
+			this->clearExamples();
+		}
+
+		//----------
+		const vector<JointType> & PoseClassifier::getJoints() const {
+			return this->joints;
+		}
+
+		//----------
+		int PoseClassifier::getDimensions() const {
+			return (int) this->joints.size() * (this->includeOrientations ? 7 : 3);
+		}
+
+		//----------
+		void PoseClassifier::setK(int k) {
+			this->k = std::max(k, 1);
+		}
+
+		//----------
+		int PoseClassifier::getK() const {
+			return this->k;
+		}
+
+		//----------
+		void PoseClassifier::setMaxDistance(float maxDistance) {
+			this->maxDistance = maxDistance;
+		}
+
+		//----------
+		float PoseClassifier::getMaxDistance() const {
+			return this->maxDistance;
+		}
+
+		//----------
+		int PoseClassifier::addExample(const string & label, const Data::Body & body) {
+			vector<float> features(this->getDimensions());
+			if (!this->computeFeatures(body, features.data())) {
+				OFXKINECTFORWINDOWS2_WARNING << "Can't add example '" << label << "', body can't be normalised";
+				return -1;
+			}
+			return this->addExample(label, features);
+		}
+
+		//----------
+		int PoseClassifier::addExample(const string & label, const vector<float> & features) {
+			if (features.size() != this->getDimensions()) {
+				OFXKINECTFORWINDOWS2_ERROR << "Example '" << label << "' has " << features.size() << " features, expected " << this->getDimensions();
+				return -1;
+			}
+
+			int labelIndex = this->getLabelIndex(label);
+			if (labelIndex == -1) {
+				labelIndex = (int) this->labels.size();
+				this->labels.push_back(label);
+			}
+
+			this->exampleLabels.push_back(labelIndex);
+			this->exampleFeatures.insert(this->exampleFeatures.end(), features.begin(), features.end());
+			this->dirty = true;
+			return (int) this->exampleLabels.size() - 1;
+		}
+
+		//----------
+		void PoseClassifier::clearExamples() {
+			this->labels.clear();
+			this->exampleLabels.clear();
+			this->exampleFeatures.clear();
+			this->dirty = true;
+		}
+
+		//----------
+		int PoseClassifier::getExampleCount() const {
+			return (int) this->exampleLabels.size();
+		}
+
+		//----------
+		int PoseClassifier::getLabelIndex(const string & label) const {
+			for (int i = 0; i < (int) this->labels.size(); i++) {
+				if (this->labels[i] == label) {
+					return i;
+				}
+			}
+			return -1;
+		}
+
+		//----------
+		const string & PoseClassifier::getLabel(int labelIndex) const {
+			if (labelIndex < 0 || labelIndex >= (int) this->labels.size()) {
+				throw Exception("PoseClassifier label index out of range");
+			}
+			return this->labels[labelIndex];
+		}
+
+		//----------
+		const vector<string> & PoseClassifier::getLabels() const {
+			return this->labels;
+		}
+
+		//----------
+		bool PoseClassifier::load(const string & path) {
+			auto buffer = ofBufferFromFile(path, true);
+			BinaryReader reader(buffer.getData(), buffer.size());
+
+			char magic[4];
+			uint32_t version, jointCount, includeOrientations, labelCount, exampleCount;
+			if (!reader.read(magic, 4) || memcmp(magic, "KPOS", 4) != 0) {
+				OFXKINECTFORWINDOWS2_ERROR << "'" << path << "' is not a pose file";
+				return false;
+			}
+			if (!reader.read(&version) || version != POSE_CLASSIFIER_VERSION) {
+				OFXKINECTFORWINDOWS2_ERROR << "'" << path << "' has an unsupported version";
+				return false;
+			}
+
+			bool valid = reader.read(&jointCount) && jointCount > 0 && jointCount <= JointType_Count;
+			vector<uint32_t> jointTypes(valid ? jointCount : 0);
+			valid = valid && reader.read(jointTypes.data(), jointCount);
+			for (auto jointType : jointTypes) {
+				valid &= jointType < JointType_Count;
+			}
+			valid = valid && reader.read(&includeOrientations) && reader.read(&labelCount);
+			if (!valid) {
+				OFXKINECTFORWINDOWS2_ERROR << "'" << path << "' has an invalid header";
+				return false;
+			}
+
+			//parse everything before touching the classifier, so a bad file leaves it as it was
+			vector<JointType> joints;
+			for (auto jointType : jointTypes) {
+				joints.push_back((JointType) jointType);
+			}
+			const int dimensions = (int) jointCount * (includeOrientations != 0 ? 7 : 3);
+
+			vector<string> labels;
+			for (uint32_t i = 0; i < labelCount && valid; i++) {
+				uint32_t length;
+				valid = reader.read(&length) && length < buffer.size();
+				string label(valid ? length : 0, ' ');
+				valid = valid && reader.read(&label[0], length);
+				labels.push_back(label);
+			}
+
+			vector<int> exampleLabels;
+			vector<float> exampleFeatures;
+			valid = valid && reader.read(&exampleCount) && (size_t) exampleCount * dimensions * sizeof(float) <= buffer.size();
+			if (valid) {
+				exampleLabels.resize(exampleCount);
+				exampleFeatures.resize((size_t) exampleCount * dimensions);
+				for (uint32_t i = 0; i < exampleCount && valid; i++) {
+					uint32_t label;
+					valid = reader.read(&label) && label < labelCount
+						&& reader.read(exampleFeatures.data() + (size_t) i * dimensions, dimensions);
+					exampleLabels[i] = (int) label;
+				}
+			}
+
+			if (!valid) {
+				OFXKINECTFORWINDOWS2_ERROR << "'" << path << "' is truncated or corrupt";
+				return false;
+			}
+
+			this->joints = std::move(joints);
+			this->includeOrientations = includeOrientations != 0;
+			this->labels = std::move(labels);
+			this->exampleLabels = std::move(exampleLabels);
+			this->exampleFeatures = std::move(exampleFeatures);
+			this->dirty = true;
+			return true;
+		}
+
+		//----------
+		bool PoseClassifier::save(const string & path) const {
+			vector<char> data;
+			const uint32_t version = POSE_CLASSIFIER_VERSION;
+			const uint32_t jointCount = (uint32_t) this->joints.size();
+			const uint32_t includeOrientations = this->includeOrientations ? 1 : 0;
+			const uint32_t labelCount = (uint32_t) this->labels.size();
+			const uint32_t exampleCount = (uint32_t) this->exampleLabels.size();
+			const int dimensions = this->getDimensions();
+
+			writeBinary(data, "KPOS", 4);
+			writeBinary(data, &version);
+			writeBinary(data, &jointCount);
+			for (auto jointType : this->joints) {
+				uint32_t value = (uint32_t) jointType;
+				writeBinary(data, &value);
+			}
+			writeBinary(data, &includeOrientations);
+			writeBinary(data, &labelCount);
+			for (const auto & label : this->labels) {
+				uint32_t length = (uint32_t) label.size();
+				writeBinary(data, &length);
+				writeBinary(data, label.data(), length);
+			}
+			writeBinary(data, &exampleCount);
+			for (uint32_t i = 0; i < exampleCount; i++) {
+				uint32_t label = (uint32_t) this->exampleLabels[i];
+				writeBinary(data, &label);
+				writeBinary(data, this->exampleFeatures.data() + (size_t) i * dimensions, dimensions);
+			}
+
+			if (!ofBufferToFile(path, ofBuffer(data.data(), data.size()), true)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Failed to write '" << path << "'";
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		bool PoseClassifier::computeFeatures(const Data::Body & body, float * features) const {
+			const auto & positions = body.jointArrays.positions;
+			const ofVec3f & origin = positions[JointType_SpineShoulder];
+			const float scale = origin.distance(positions[JointType_SpineBase]);
+			if (scale < 1e-3f) {
+				return false;
+			}
+			const float inverseScale = 1.0f / scale;
+
+			//rotate about the vertical axis so that the shoulders lie along +x
+			ofVec3f shoulders = positions[JointType_ShoulderRight] - positions[JointType_ShoulderLeft];
+			float angle = atan2(shoulders.z, shoulders.x);
+			float cosAngle = cos(angle) * inverseScale;
+			float sinAngle = sin(angle) * inverseScale;
+
+			for (const auto & jointType : this->joints) {
+				ofVec3f position = positions[jointType] - origin;
+				*features++ = position.x * cosAngle + position.z * sinAngle;
+				*features++ = position.y * inverseScale;
+				*features++ = position.z * cosAngle - position.x * sinAngle;
+			}
+
+			if (this->includeOrientations) {
+				//camera space orientations, with the sign chosen so that q and -q match
+				for (const auto & jointType : this->joints) {
+					const auto & orientation = body.jointArrays.orientations[jointType];
+					float sign = orientation.w() < 0.0f ? -1.0f : 1.0f;
+					*features++ = orientation.x() * sign;
+					*features++ = orientation.y() * sign;
+					*features++ = orientation.z() * sign;
+					*features++ = orientation.w() * sign;
+				}
+			}
+			return true;
+		}
+
+		//----------
+		void PoseClassifier::findNearest(const float * features, int k, vector<Neighbour> & result) {
+			result.clear();
+			if (this->dirty) {
+				this->build();
+			}
+			if (this->nodes.empty()) {
+				return;
+			}
+
+			this->search(0, features, k, result);
+			for (auto & neighbour : result) {
+				neighbour.distance = sqrt(neighbour.distance);
+			}
+		}
+
+		//----------
+		bool PoseClassifier::classify(const Data::Body & body, Result & result) {
+			result.body = -1;
+			result.trackingId = body.trackingId;
+			result.label = -1;
+			result.confidence = 0.0f;
+			result.distance = std::numeric_limits<float>::infinity();
+
+			this->queryFeatures.resize(this->getDimensions());
+			if (!body.tracked || !this->computeFeatures(body, this->queryFeatures.data())) {
+				return false;
+			}
+
+			this->findNearest(this->queryFeatures.data(), this->k, this->neighbours);
+			if (this->neighbours.empty()) {
+				return false;
+			}
+
+			//majority vote, ties go to the label with the nearest example
+			this->votes.assign(this->labels.size(), 0.0f);
+			float bestVotes = 0.0f;
+			for (const auto & neighbour : this->neighbours) {
+				float & votes = this->votes[neighbour.label];
+				votes += 1.0f;
+				if (votes > bestVotes) {
+					bestVotes = votes;
+					result.label = neighbour.label;
+				}
+			}
+			result.confidence = bestVotes / (float) this->k;
+			for (const auto & neighbour : this->neighbours) {
+				if (neighbour.label == result.label) {
+					result.distance = neighbour.distance;
+					break;
+				}
+			}
+			return true;
+		}
+
+		//----------
+		const vector<PoseClassifier::Result> & PoseClassifier::update(const vector<Data::Body> & bodies) {
+			for (int b = 0; b < BODY_COUNT; b++) {
+				auto & result = this->results[b];
+				if (b < (int) bodies.size()) {
+					this->classify(bodies[b], result);
+				}
+				else {
+					result = Result();
+				}
+				result.body = b;
+			}
+			return this->results;
+		}
+
+		//----------
+		const vector<PoseClassifier::Result> & PoseClassifier::getResults() const {
+			return this->results;
+		}
+
+		//----------
+		void PoseClassifier::build() {
+			const int dimensions = this->getDimensions();
+			const int count = (int) this->exampleLabels.size();
+
+			this->nodes.clear();
+			this->pointExamples.resize(count);
+			for (int i = 0; i < count; i++) {
+				this->pointExamples[i] = i;
+			}
+
+			if (count > 0) {
+				this->nodes.reserve(2 * count / POSE_CLASSIFIER_LEAF_SIZE + 1);
+				this->buildNode(0, count);
+			}
+
+			//gather features in tree order so that leaves are scanned linearly
+			this->pointFeatures.resize((size_t) count * dimensions);
+			for (int i = 0; i < count; i++) {
+				const float * source = this->exampleFeatures.data() + (size_t) this->pointExamples[i] * dimensions;
+				std::copy(source, source + dimensions, this->pointFeatures.data() + (size_t) i * dimensions);
+			}
+
+			this->dirty = false;
+		}
+
+		//----------
+		int PoseClassifier::buildNode(int begin, int end) {
+			const int dimensions = this->getDimensions();
+			const int index = (int) this->nodes.size();
+			this->nodes.push_back(Node());
+
+			Node node;
+			node.dimension = -1;
+			node.split = 0.0f;
+			node.begin = begin;
+			node.end = end;
+			node.left = -1;
+			node.right = -1;
+
+			if (end - begin > POSE_CLASSIFIER_LEAF_SIZE) {
+				//split on the dimension with the largest spread
+				float largestSpread = 0.0f;
+				for (int d = 0; d < dimensions; d++) {
+					float minimum = std::numeric_limits<float>::max();
+					float maximum = -std::numeric_limits<float>::max();
+					for (int i = begin; i < end; i++) {
+						float value = this->exampleFeatures[(size_t) this->pointExamples[i] * dimensions + d];
+						minimum = std::min(minimum, value);
+						maximum = std::max(maximum, value);
+					}
+					if (maximum - minimum > largestSpread) {
+						largestSpread = maximum - minimum;
+						node.dimension = d;
+					}
+				}
+
+				if (node.dimension != -1) {
+					const int middle = (begin + end) / 2;
+					const int dimension = node.dimension;
+					const auto & features = this->exampleFeatures;
+					std::nth_element(this->pointExamples.begin() + begin, this->pointExamples.begin() + middle, this->pointExamples.begin() + end,
+						[&features, dimensions, dimension](int a, int b) {
+						return features[(size_t) a * dimensions + dimension] < features[(size_t) b * dimensions + dimension];
+					});
+					node.split = features[(size_t) this->pointExamples[middle] * dimensions + dimension];
+					node.left = this->buildNode(begin, middle);
+					node.right = this->buildNode(middle, end);
+				}
+			}
+
+			this->nodes[index] = node;
+			return index;
+		}
+
+		//----------
+		void PoseClassifier::search(int nodeIndex, const float * features, int k, vector<Neighbour> & result) const {
+			const auto & node = this->nodes[nodeIndex];
+			const int dimensions = this->getDimensions();
+			const float maxDistanceSquared = this->maxDistance * this->maxDistance;
+
+			if (node.dimension == -1) {
+				for (int i = node.begin; i < node.end; i++) {
+					const float bound = (int) result.size() < k ? maxDistanceSquared : result.back().distance;
+					const float * point = this->pointFeatures.data() + (size_t) i * dimensions;
+
+					float distance = 0.0f;
+					for (int d = 0; d < dimensions && distance <= bound; d++) {
+						float difference = features[d] - point[d];
+						distance += difference * difference;
+					}
+					if (distance > bound) {
+						continue;
+					}
+
+					Neighbour neighbour;
+					neighbour.example = this->pointExamples[i];
+					neighbour.label = this->exampleLabels[neighbour.example];
+					neighbour.distance = distance;
+
+					//insert in order (distances are squared until findNearest returns)
+					if ((int) result.size() == k) {
+						result.pop_back();
+					}
+					auto position = std::upper_bound(result.begin(), result.end(), neighbour, [](const Neighbour & a, const Neighbour & b) {
+						return a.distance < b.distance;
+					});
+					result.insert(position, neighbour);
+				}
+			}
+			else {
+				const float difference = features[node.dimension] - node.split;
+				const int nearChild = difference < 0.0f ? node.left : node.right;
+				const int farChild = difference < 0.0f ? node.right : node.left;
+
+				this->search(nearChild, features, k, result);
+
+				const float bound = (int) result.size() < k ? maxDistanceSquared : result.back().distance;
+				if (difference * difference <= bound) {
+					this->search(farChild, features, k, result);
+				}
+			}
+		}
+	}
+}
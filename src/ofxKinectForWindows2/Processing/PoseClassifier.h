@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../Utils.h"
+#include "../Data/Body.h"
+
+#include <Kinect.h>
+
+namespace ofxKinectForWindows2 {
+	namespace Processing {
+		// Classifies static poses (arms up, T-pose, ...) by k nearest neighbours over labelled examples.
+		//
+		// Features are joint positions relative to the SpineShoulder, rotated so the shoulders face the sensor
+		// and scaled by the torso length, optionally followed by joint orientations.
+		// Examples are indexed in a k-d tree which is rebuilt lazily after examples are added.
+		//
+		// Binary file layout (little endian) :
+		//	"KPOS", uint32 version, uint32 jointCount, uint32 joints[jointCount], uint32 includeOrientations,
+		//	uint32 labelCount, { uint32 length, char name[length] } x labelCount,
+		//	uint32 exampleCount, { uint32 label, float features[dimensions] } x exampleCount
+		class PoseClassifier {
+		public:
+			struct Neighbour {
+				int example;
+				int label;
+				float distance; // euclidean, in feature space
+			};
+
+			struct Result {
+				int body = -1;
+				UINT64 trackingId = 0;
+				int label = -1; // -1 if not tracked or no neighbour is close enough
+				float confidence = 0.0f; // fraction of the k neighbours voting for label
+				float distance = 0.0f; // to the nearest neighbour with this label
+			};
+
+			PoseClassifier();
+
+			// Joints used for features. Changing them clears all examples.
+			void setJoints(const vector<JointType> &, bool includeOrientations = false);
+			const vector<JointType> & getJoints() const;
+			int getDimensions() const;
+
+			void setK(int);
+			int getK() const;
+			// Neighbours further than this are ignored
+			void setMaxDistance(float);
+			float getMaxDistance() const;
+
+			// Returns the example index, or -1 if the body can't be normalised
+			int addExample(const string & label, const Data::Body &);
+			int addExample(const string & label, const vector<float> & features);
+			void clearExamples();
+			int getExampleCount() const;
+
+			int getLabelIndex(const string & label) const;
+			const string & getLabel(int labelIndex) const;
+			const vector<string> & getLabels() const;
+
+			bool load(const string & path);
+			bool save(const string & path) const;
+
+			// Normalised features of one body (getDimensions() floats). Returns false if the body can't be normalised.
+			bool computeFeatures(const Data::Body &, float * features) const;
+
+			// Nearest examples to these features, closest first
+			void findNearest(const float * features, int k, vector<Neighbour> & result);
+			bool classify(const Data::Body &, Result &);
+
+			// Classify all bodies. Results are indexed by body.
+			const vector<Result> & update(const vector<Data::Body> &);
+			const vector<Result> & getResults() const;
+		protected:
+			struct Node {
+				int dimension; // -1 for a leaf
+				float split;
+				int begin; // leaves : range of points
+				int end;
+				int left; // branches : child nodes
+				int right;
+			};
+
+			void build();
+			int buildNode(int begin, int end);
+			void search(int node, const float * features, int k, vector<Neighbour> & result) const;
+
+			vector<JointType> joints;
+			bool includeOrientations;
+			int k;
+			float maxDistance;
+
+			vector<string> labels;
+			vector<int> exampleLabels;
+			vector<float> exampleFeatures; // exampleCount x dimensions
+
+			// k-d tree, with points reordered so that each leaf is a contiguous range
+			bool dirty;
+			vector<Node> nodes;
+			vector<int> pointExamples;
+			vector<float> pointFeatures;
+
+			vector<float> queryFeatures;
+			vector<Neighbour> neighbours;
+			vector<float> votes;
+			vector<Result> results;
+		};
+	}
+}
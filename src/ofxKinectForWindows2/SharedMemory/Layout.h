@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		// Memory layout shared by Publisher and Reader (and readers in other languages).
+		// Each stream is a named mapping ("Local\<name>_<Stream>" on Windows) holding a StreamHeader then
+		// slotCount slots of slotSize bytes. A slot is a SlotHeader followed by the frame data.
+		// Slots are seqlocks : sequence is odd while the publisher writes the slot, and changes whenever the slot
+		// is rewritten. A restarted publisher carries the sequences on, so they never repeat while the mapping lives.
+		// The latest complete frame is in slot (frameCount - 1) % slotCount.
+		enum {
+			Magic = 0x4D53464B, // "KFSM"
+			Version = 1,
+			DefaultSlotCount = 3
+		};
+
+		enum Stream {
+			Stream_Depth = 0,
+			Stream_Color,
+			Stream_Infrared,
+			Stream_LongExposureInfrared,
+			Stream_BodyIndex,
+			Stream_Body,
+			Stream_Count
+		};
+
+		enum Format {
+			Format_Gray16 = 0,
+			Format_Gray8,
+			Format_RGBA,
+			Format_YUY2,
+			Format_BodyRawFrame // Source::Body::RawFrame
+		};
+
+		struct StreamHeader {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t stream;
+			uint32_t slotCount;
+			uint64_t slotSize; // bytes, multiple of 64
+			std::atomic<uint64_t> frameCount;
+			uint8_t padding[32];
+		};
+
+		struct SlotHeader {
+			std::atomic<uint64_t> sequence;
+			uint64_t frameNumber; // 1 for the first frame of the stream
+			uint64_t timestamp; // publisher's steady clock, microseconds
+			uint32_t format;
+			uint32_t width;
+			uint32_t height;
+			uint32_t size; // bytes of frame data
+			uint8_t padding[24];
+		};
+
+		static_assert(sizeof(StreamHeader) == 64 && sizeof(SlotHeader) == 64, "Shared memory headers must stay 64 bytes");
+
+		inline const char * getStreamName(Stream stream) {
+			static const char * names[Stream_Count] = { "Depth", "Color", "Infrared", "LongExposureInfrared", "BodyIndex", "Body" };
+			return stream < Stream_Count ? names[stream] : "Unknown";
+		}
+
+		inline std::string getDefaultName() {
+			return "ofxKinectForWindows2";
+		}
+	}
+}
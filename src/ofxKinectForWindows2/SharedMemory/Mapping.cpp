@@ -0,0 +1,152 @@
+#include "Mapping.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		//----------
+		static std::string getSystemName(const std::string & name) {
+#ifdef _WIN32
+			return "Local\\" + name;
+#else
+			return "/" + name;
+#endif
+		}
+
+		//----------
+		Mapping::Mapping() {
+#ifdef _WIN32
+			this->handle = nullptr;
+#else
+			this->handle = -1;
+			this->owner = false;
+#endif
+			this->data = nullptr;
+			this->size = 0;
+		}
+
+		//----------
+		Mapping::~Mapping() {
+			this->close();
+		}
+
+		//----------
+		bool Mapping::create(const std::string & name, size_t size) {
+			this->close();
+			const auto systemName = getSystemName(name);
+#ifdef _WIN32
+			this->handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD) ((uint64_t) size >> 32), (DWORD) size, systemName.c_str());
+			if (!this->handle) {
+				return false;
+			}
+			this->data = (uint8_t *) MapViewOfFile(this->handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+			this->handle = shm_open(systemName.c_str(), O_CREAT | O_RDWR, 0666);
+			if (this->handle < 0) {
+				return false;
+			}
+			this->owner = true;
+			this->name = systemName;
+			if (ftruncate(this->handle, size) != 0) {
+				this->close();
+				return false;
+			}
+			void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->handle, 0);
+			this->data = data == MAP_FAILED ? nullptr : (uint8_t *) data;
+#endif
+			if (!this->data) {
+				this->close();
+				return false;
+			}
+			this->size = size;
+			return true;
+		}
+
+		//----------
+		bool Mapping::open(const std::string & name) {
+			this->close();
+			const auto systemName = getSystemName(name);
+#ifdef _WIN32
+			this->handle = OpenFileMappingA(FILE_MAP_READ, FALSE, systemName.c_str());
+			if (!this->handle) {
+				return false;
+			}
+			this->data = (uint8_t *) MapViewOfFile(this->handle, FILE_MAP_READ, 0, 0, 0);
+			if (this->data) {
+				MEMORY_BASIC_INFORMATION information;
+				VirtualQuery(this->data, &information, sizeof(information));
+				this->size = information.RegionSize;
+			}
+#else
+			this->handle = shm_open(systemName.c_str(), O_RDONLY, 0);
+			if (this->handle < 0) {
+				return false;
+			}
+			struct stat status;
+			if (fstat(this->handle, &status) != 0 || status.st_size == 0) {
+				this->close();
+				return false;
+			}
+			void * data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, this->handle, 0);
+			if (data != MAP_FAILED) {
+				this->data = (uint8_t *) data;
+				this->size = status.st_size;
+			}
+#endif
+			if (!this->data) {
+				this->close();
+				return false;
+			}
+			return true;
+		}
+
+		//----------
+		void Mapping::close() {
+#ifdef _WIN32
+			if (this->data) {
+				UnmapViewOfFile(this->data);
+			}
+			if (this->handle) {
+				CloseHandle(this->handle);
+				this->handle = nullptr;
+			}
+#else
+			if (this->data) {
+				munmap(this->data, this->size);
+			}
+			if (this->handle >= 0) {
+				::close(this->handle);
+				this->handle = -1;
+			}
+			if (this->owner) {
+				shm_unlink(this->name.c_str());
+				this->owner = false;
+			}
+#endif
+			this->data = nullptr;
+			this->size = 0;
+		}
+
+		//----------
+		bool Mapping::isOpen() const {
+			return this->data != nullptr;
+		}
+
+		//----------
+		uint8_t * Mapping::getData() const {
+			return this->data;
+		}
+
+		//----------
+		size_t Mapping::getSize() const {
+			return this->size;
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		// Named shared memory. The publisher creates it read/write, readers open it read only.
+		class Mapping {
+		public:
+			Mapping();
+			~Mapping();
+
+			bool create(const std::string & name, size_t size);
+			bool open(const std::string & name);
+			void close();
+
+			bool isOpen() const;
+			uint8_t * getData() const;
+			size_t getSize() const;
+		protected:
+			Mapping(const Mapping &) = delete;
+			Mapping & operator=(const Mapping &) = delete;
+
+#ifdef _WIN32
+			void * handle;
+#else
+			int handle;
+			bool owner;
+			std::string name;
+#endif
+			uint8_t * data;
+			size_t size;
+		};
+	}
+}
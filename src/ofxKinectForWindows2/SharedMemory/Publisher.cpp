@@ -0,0 +1,218 @@
+#include "Publisher.h"
+#include "../Device.h"
+#include "ofMain.h"
+
+#include <chrono>
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		//----------
+		static size_t getMaxFrameSize(Stream stream) {
+			switch (stream) {
+			case Stream_Depth:
+			case Stream_Infrared:
+			case Stream_LongExposureInfrared:
+				return 512 * 424 * sizeof(unsigned short);
+			case Stream_BodyIndex:
+				return 512 * 424;
+			case Stream_Color:
+				return 1920 * 1080 * 4;
+			case Stream_Body:
+				return sizeof(Source::Body::RawFrame);
+			default:
+				return 0;
+			}
+		}
+
+		//----------
+		Publisher::Publisher() {
+			this->opened = false;
+			this->slotCount = DefaultSlotCount;
+		}
+
+		//----------
+		void Publisher::setSlotCount(int slotCount) {
+			if (this->opened) {
+				OFXKINECTFORWINDOWS2_WARNING << "Slot count can only be changed before open()";
+				return;
+			}
+			this->slotCount = std::max(slotCount, 2);
+		}
+
+		//----------
+		int Publisher::getSlotCount() const {
+			return this->slotCount;
+		}
+
+		//----------
+		bool Publisher::open(const std::string & name) {
+			this->close();
+			this->name = name;
+			this->opened = true;
+			return true;
+		}
+
+		//----------
+		void Publisher::close() {
+			for (auto & channel : this->channels) {
+				channel.mapping.close();
+				channel.frameCount = 0;
+			}
+			this->opened = false;
+		}
+
+		//----------
+		bool Publisher::isOpen() const {
+			return this->opened;
+		}
+
+		//----------
+		const std::string & Publisher::getName() const {
+			return this->name;
+		}
+
+		//----------
+		void Publisher::publish(const Device & device) {
+			if (!this->opened) {
+				return;
+			}
+
+			auto depth = device.getDepthSource();
+			if (depth && depth->isFrameNew()) {
+				const auto & pixels = depth->getPixels();
+				this->publish(Stream_Depth, Format_Gray16, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+			}
+
+			auto color = device.getColorSource();
+			if (color && color->isFrameNew()) {
+				if (color->getRgbaPixelsEnabled()) {
+					const auto & pixels = color->getPixels();
+					this->publish(Stream_Color, Format_RGBA, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+				}
+				else if (color->getYuvPixelsEnabled()) {
+					const auto & pixels = color->getYuvPixels();
+					this->publish(Stream_Color, Format_YUY2, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+				}
+			}
+
+			auto infrared = device.getInfraredSource();
+			if (infrared && infrared->isFrameNew()) {
+				const auto & pixels = infrared->getPixels();
+				this->publish(Stream_Infrared, Format_Gray16, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+			}
+
+			auto longExposureInfrared = device.getLongExposureInfraredSource();
+			if (longExposureInfrared && longExposureInfrared->isFrameNew()) {
+				const auto & pixels = longExposureInfrared->getPixels();
+				this->publish(Stream_LongExposureInfrared, Format_Gray16, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+			}
+
+			auto bodyIndex = device.getBodyIndexSource();
+			if (bodyIndex && bodyIndex->isFrameNew()) {
+				const auto & pixels = bodyIndex->getPixels();
+				this->publish(Stream_BodyIndex, Format_Gray8, pixels.getWidth(), pixels.getHeight(), pixels.getData(), pixels.getTotalBytes());
+			}
+
+			auto body = device.getBodySource();
+			if (body && body->isFrameNew()) {
+				Source::Body::RawFrame rawFrame;
+				body->getRawFrame(rawFrame);
+				this->publish(Stream_Body, Format_BodyRawFrame, BODY_COUNT, JointType_Count, &rawFrame, sizeof(rawFrame));
+			}
+		}
+
+		//----------
+		bool Publisher::publish(Stream stream, Format format, int width, int height, const void * data, size_t size) {
+			if (!this->opened || stream >= Stream_Count || size == 0) {
+				return false;
+			}
+			auto & channel = this->channels[stream];
+			if (!channel.mapping.isOpen() && !this->openChannel(stream)) {
+				return false;
+			}
+
+			auto header = (StreamHeader *) channel.mapping.getData();
+			if (size > header->slotSize - sizeof(SlotHeader)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Frame of " << size << " bytes is too large for the " << getStreamName(stream) << " stream";
+				return false;
+			}
+
+			const uint64_t frameNumber = channel.frameCount + 1;
+			auto slot = (SlotHeader *) (channel.mapping.getData() + sizeof(StreamHeader) + (frameNumber - 1) % header->slotCount * header->slotSize);
+
+			//seqlock write : odd while writing, then even again with a new value
+			const uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+			slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			slot->frameNumber = frameNumber;
+			slot->timestamp = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			slot->format = format;
+			slot->width = width;
+			slot->height = height;
+			slot->size = (uint32_t) size;
+			memcpy((uint8_t *) slot + sizeof(SlotHeader), data, size);
+
+			slot->sequence.store(sequence + 2, std::memory_order_release);
+			header->frameCount.store(frameNumber, std::memory_order_release);
+			channel.frameCount = frameNumber;
+			return true;
+		}
+
+		//----------
+		uint64_t Publisher::getFrameCount(Stream stream) const {
+			return stream < Stream_Count ? this->channels[stream].frameCount : 0;
+		}
+
+		//----------
+		bool Publisher::openChannel(Stream stream) {
+			const size_t slotSize = (sizeof(SlotHeader) + getMaxFrameSize(stream) + 63) & ~(size_t) 63;
+			auto & mapping = this->channels[stream].mapping;
+			if (!mapping.create(this->name + "_" + getStreamName(stream), sizeof(StreamHeader) + slotSize * this->slotCount)) {
+				OFXKINECTFORWINDOWS2_ERROR << "Failed to create shared memory for the " << getStreamName(stream) << " stream";
+				return false;
+			}
+
+			//the mapping outlives us while a reader holds it, and that reader may still hold a frame from the
+			//previous publisher. Carry the slot sequences on past anything handed out, so that a rewritten slot
+			//can't come back with the sequence the reader checks against (isValid would pass on the new data)
+			auto header = (StreamHeader *) mapping.getData();
+			uint64_t sequence = 0;
+			if (header->magic == Magic && header->version == Version) {
+				for (uint64_t i = 0; i < header->slotCount && sizeof(StreamHeader) + (i + 1) * header->slotSize <= mapping.getSize(); i++) {
+					auto slot = (const SlotHeader *) (mapping.getData() + sizeof(StreamHeader) + i * header->slotSize);
+					sequence = std::max(sequence, slot->sequence.load(std::memory_order_relaxed));
+				}
+			}
+			//even, and beyond a slot left mid-write
+			sequence = (sequence + 2) & ~(uint64_t) 1;
+
+			//readers may be looking at the header while we rewrite it. Withdraw the magic and the frames first,
+			//fill everything else, then give the magic back last
+			header->magic = 0;
+			header->frameCount.store(0, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			header->version = Version;
+			header->stream = stream;
+			header->slotCount = this->slotCount;
+			header->slotSize = slotSize;
+			memset(header->padding, 0, sizeof(header->padding));
+			for (int i = 0; i < this->slotCount; i++) {
+				auto slot = (SlotHeader *) (mapping.getData() + sizeof(StreamHeader) + i * slotSize);
+				slot->sequence.store(sequence - 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				slot->frameNumber = 0;
+				slot->timestamp = 0;
+				slot->format = 0;
+				slot->width = 0;
+				slot->height = 0;
+				slot->size = 0;
+				memset(slot->padding, 0, sizeof(slot->padding));
+				slot->sequence.store(sequence, std::memory_order_release);
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+			header->magic = Magic;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Layout.h"
+#include "Mapping.h"
+
+#include <stdint.h>
+
+namespace ofxKinectForWindows2 {
+	class Device;
+
+	namespace SharedMemory {
+		// Copies the new frames of a Device into shared memory rings, where any number of processes on this machine
+		// can read them without copies or sockets (see Reader and Layout.h). Usually owned by the Device
+		// (Device::openSharedMemoryPublisher) which publishes at the end of each update().
+		// Colour is published as RGBA, or YUY2 when the source's RGBA pixels are disabled.
+		class Publisher {
+		public:
+			Publisher();
+
+			// Slots per stream, set before open (default 3). Readers have slotCount - 1 frame periods to use a frame.
+			void setSlotCount(int);
+			int getSlotCount() const;
+
+			bool open(const std::string & name = getDefaultName());
+			void close();
+			bool isOpen() const;
+			const std::string & getName() const;
+
+			void publish(const Device &);
+			// Publish one frame of a stream (data is copied)
+			bool publish(Stream, Format, int width, int height, const void * data, size_t size);
+
+			uint64_t getFrameCount(Stream) const;
+		protected:
+			struct Channel {
+				Mapping mapping;
+				uint64_t frameCount = 0;
+			};
+
+			bool openChannel(Stream);
+
+			std::string name;
+			bool opened;
+			int slotCount;
+			Channel channels[Stream_Count];
+		};
+	}
+}
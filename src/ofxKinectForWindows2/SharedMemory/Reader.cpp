@@ -0,0 +1,117 @@
+#include "Reader.h"
+
+#include <cstring>
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		//----------
+		Reader::Reader() {
+			this->name = getDefaultName();
+		}
+
+		//----------
+		void Reader::open(const std::string & name) {
+			this->close();
+			this->name = name;
+		}
+
+		//----------
+		void Reader::close() {
+			for (auto & mapping : this->mappings) {
+				mapping.close();
+			}
+		}
+
+		//----------
+		bool Reader::getLatest(Stream stream, Frame & frame) {
+			uint32_t slotCount;
+			uint64_t slotSize;
+			auto header = this->getHeader(stream, slotCount, slotSize);
+			if (!header) {
+				return false;
+			}
+
+			//the slot may be reused while we look at it, in which case look again
+			for (int attempt = 0; attempt < 4; attempt++) {
+				const uint64_t frameCount = header->frameCount.load(std::memory_order_acquire);
+				if (frameCount == 0) {
+					return false;
+				}
+				auto slot = (const SlotHeader *) ((const uint8_t *) header + sizeof(StreamHeader) + (frameCount - 1) % slotCount * slotSize);
+				const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+				if (sequence & 1) {
+					continue;
+				}
+
+				frame.data = (const uint8_t *) slot + sizeof(SlotHeader);
+				frame.size = slot->size;
+				frame.format = (Format) slot->format;
+				frame.width = slot->width;
+				frame.height = slot->height;
+				frame.frameNumber = slot->frameNumber;
+				frame.timestamp = slot->timestamp;
+				frame.slot = slot;
+				frame.sequence = sequence;
+
+				if (this->isValid(frame) && frame.size <= slotSize - sizeof(SlotHeader)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//----------
+		bool Reader::isValid(const Frame & frame) const {
+			if (!frame.slot) {
+				return false;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return frame.slot->sequence.load(std::memory_order_relaxed) == frame.sequence;
+		}
+
+		//----------
+		bool Reader::copyLatest(Stream stream, std::vector<uint8_t> & data, Frame & frame) {
+			for (int attempt = 0; attempt < 4; attempt++) {
+				if (!this->getLatest(stream, frame)) {
+					return false;
+				}
+				data.resize(frame.size);
+				memcpy(data.data(), frame.data, frame.size);
+				if (this->isValid(frame)) {
+					frame.data = data.data();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//----------
+		const StreamHeader * Reader::getHeader(Stream stream, uint32_t & slotCount, uint64_t & slotSize) {
+			if (stream >= Stream_Count) {
+				return nullptr;
+			}
+			auto & mapping = this->mappings[stream];
+			if (!mapping.isOpen() && !mapping.open(this->name + "_" + getStreamName(stream))) {
+				return nullptr;
+			}
+
+			auto header = (const StreamHeader *) mapping.getData();
+			if (mapping.getSize() < sizeof(StreamHeader) || header->magic != Magic || header->version != Version) {
+				//not ready yet (or not ours), try again next time
+				mapping.close();
+				return nullptr;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			//only the copies are used from here on, so they must fit the mapping
+			slotCount = header->slotCount;
+			slotSize = header->slotSize;
+			if (slotCount == 0 || slotSize < sizeof(SlotHeader)
+				|| slotSize > (mapping.getSize() - sizeof(StreamHeader)) / slotCount) {
+				mapping.close();
+				return nullptr;
+			}
+			return header;
+		}
+	}
+}
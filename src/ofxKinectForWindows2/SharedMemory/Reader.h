@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Layout.h"
+#include "Mapping.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace SharedMemory {
+		// Reads the streams of a Publisher in another process. Streams are opened on first use, so the reader
+		// may start before the publisher. getLatest() points straight into shared memory : check isValid()
+		// after using the data, in case the publisher has reused the slot meanwhile.
+		class Reader {
+		public:
+			struct Frame {
+				const void * data = nullptr;
+				uint32_t size = 0;
+				Format format = Format_Gray16;
+				uint32_t width = 0;
+				uint32_t height = 0;
+				uint64_t frameNumber = 0;
+				uint64_t timestamp = 0; // publisher's steady clock, microseconds
+
+				const SlotHeader * slot = nullptr;
+				uint64_t sequence = 0;
+			};
+
+			Reader();
+
+			void open(const std::string & name = getDefaultName());
+			void close();
+
+			// Zero copy access to the latest complete frame. Returns false if there is none yet.
+			bool getLatest(Stream, Frame &);
+			// False if the frame's slot has been (or is being) rewritten since getLatest
+			bool isValid(const Frame &) const;
+
+			// Copy of the latest frame, retried until it is consistent. frame.data points into the copy.
+			bool copyLatest(Stream, std::vector<uint8_t> & data, Frame & frame);
+		protected:
+			// slotCount and slotSize are copied out once checked, the publisher may rewrite the header meanwhile
+			const StreamHeader * getHeader(Stream, uint32_t & slotCount, uint64_t & slotSize);
+
+			std::string name;
+			Mapping mappings[Stream_Count];
+		};
+	}
+}
@@ -42,6 +42,12 @@ namespace ofxKinectForWindows2 {
 				return false;
 		}
 
+		//----------
+		template <typename ReaderType, typename FrameType>
+		void BaseFrame <typename ReaderType, typename FrameType>::clearFrameNew() {
+			this->isFrameNewFlag = false;
+		}
+
 		//----------
 		template <typename ReaderType, typename FrameType>
 		void BaseFrame<typename ReaderType, typename FrameType>::update() {
@@ -75,6 +81,8 @@ namespace ofxKinectForWindows2 {
 			this->horizontalFieldOfView = 0.0f;
 			this->verticalFieldOfView = 0.0f;
 			this->lastFrameTime = 0;
+			this->framesEnabled = false;
+			this->frameCount = 0;
 
 			if (this->frustumMesh.getVertices().empty()) {
 				this->frustumMesh.addVertex(ofVec3f(0.0f, 0.0f, 0.0f));
@@ -177,6 +185,96 @@ namespace ofxKinectForWindows2 {
 			ofPopMatrix();
 		}
 
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		void BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::loadFrame(const ofPixels_<PixelType> & pixels, INT64 relativeTime) {
+			this->isFrameNewFlag = true;
+			this->lastFrameTime = relativeTime;
+			this->allocatePixels(pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat());
+			memcpy(this->pixels.getData(), pixels.getData(), pixels.getTotalBytes());
+			this->pixelsUpdated();
+			this->publishFrame(relativeTime);
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		INT64 BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::getRelativeTime() const {
+			return this->lastFrameTime;
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		void BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::setFramesEnabled(bool framesEnabled) {
+			this->framesEnabled = framesEnabled;
+			if (!framesEnabled) {
+				std::atomic_store(&this->frame, std::shared_ptr<const Data::Frame<PixelType>>());
+				this->framePool.clear();
+			}
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		bool BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::getFramesEnabled() const {
+			return this->framesEnabled;
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		std::shared_ptr<const Data::Frame<PixelType>> BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::getFrame() const {
+			return std::atomic_load(&this->frame);
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		Data::FramePool<PixelType> & BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::getFramePool() {
+			return this->framePool;
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		std::shared_ptr<typename BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::FrameSubscription> BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::onFrame(const typename FrameSubscription::Callback & callback, Threading::Executor & executor, typename FrameSubscription::Policy policy) {
+			this->setFramesEnabled(true);
+			return this->frameSubscriptions.add(callback, executor, policy);
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		void BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::pixelsUpdated() {
+			if (this->useTexture) {
+				this->texture.loadData(this->pixels);
+			}
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		void BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::allocatePixels(int width, int height, ofPixelFormat pixelFormat) {
+			this->pixelsStorage.allocate(this->pixels, width, height, pixelFormat);
+			if (this->useTexture && (!this->texture.isAllocated() || this->texture.getWidth() != width || this->texture.getHeight() != height)) {
+				this->texture.allocate(this->pixels);
+			}
+		}
+
+		//----------
+		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
+		void BaseImage OFXKFW2_BaseImageSimple_TEMPLATE_ARGS_TRIM::publishFrame(INT64 relativeTime) {
+			if (!this->framesEnabled) {
+				return;
+			}
+
+			//same size pixels are copied without reallocating
+			auto frame = this->framePool.acquire();
+			frame->pixels = this->pixels;
+			frame->relativeTime = relativeTime;
+			frame->frameIndex = this->frameCount++;
+			frame->horizontalFieldOfView = this->horizontalFieldOfView;
+			frame->verticalFieldOfView = this->verticalFieldOfView;
+			std::shared_ptr<const Data::Frame<PixelType>> publishedFrame(std::move(frame));
+			std::atomic_store(&this->frame, publishedFrame);
+			if (!this->frameSubscriptions.empty()) {
+				this->frameSubscriptions.post(publishedFrame);
+			}
+		}
+
 #pragma mark BaseImageSimple
 		//----------
 		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
@@ -189,12 +287,12 @@ namespace ofxKinectForWindows2 {
 					throw Exception("Failed to get relative time");
 				}
 				
-				if (relativeTime > this->lastFrameTime) {
-					relativeTime = this->lastFrameTime;
-				} 
-				else {
+				//the reader can hand us the same frame again
+				if (relativeTime <= this->lastFrameTime) {
+					this->isFrameNewFlag = false;
 					return;
 				}
+				this->lastFrameTime = relativeTime;
 
 				//allocate pixels and texture if we need to
 				if (FAILED(frame->get_FrameDescription(&frameDescription))) {
@@ -204,18 +302,13 @@ namespace ofxKinectForWindows2 {
 				if (FAILED(frameDescription->get_Width(&width)) || FAILED(frameDescription->get_Height(&height))) {
 					throw Exception("Failed to get width and height of frame");
 				}
-				if (width != this->pixels.getWidth() || height != this->texture.getHeight()) {
-					this->pixels.allocate(width, height, OF_IMAGE_GRAYSCALE);
-					this->texture.allocate(this->pixels);
-				}
+				this->allocatePixels(width, height, OF_PIXELS_GRAY);
 
 				//update local assets
 				if (FAILED(frame->CopyFrameDataToArray(width * height, this->pixels.getData()))) {
 					throw Exception("Couldn't pull pixel buffer ");
 				}
-				if (this->useTexture) {
-					this->texture.loadData(this->pixels);
-				}
+				this->pixelsUpdated();
 
 				//update field of view
 				if (FAILED(frameDescription->get_HorizontalFieldOfView(&this->horizontalFieldOfView))) {
@@ -227,6 +320,8 @@ namespace ofxKinectForWindows2 {
 				if (FAILED(frameDescription->get_DiagonalFieldOfView(&this->diagonalFieldOfView))) {
 					throw Exception("Failed to get diagonal field of view");
 				}
+
+				this->publishFrame(relativeTime);
 			} catch (std::exception & e) {
 				OFXKINECTFORWINDOWS2_ERROR << e.what();
 			}
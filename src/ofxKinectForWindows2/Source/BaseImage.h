@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../Utils.h"
+#include "../Data/Frame.h"
+#include "../Data/PixelBufferPool.h"
+#include "../Threading/Subscription.h"
 
 #include "ofBaseTypes.h"
 #include "ofTexture.h"
@@ -25,6 +28,9 @@ namespace ofxKinectForWindows2 {
 			void update() override;
 			bool isFrameNew() const override;
 			bool hasReader() const override;
+
+			// For sources fed without a reader (e.g. by Network::Client), when there is no new frame this update
+			void clearFrameNew();
 		protected:
 			virtual void initReader(IKinectSensor *) = 0;
 
@@ -35,6 +41,8 @@ namespace ofxKinectForWindows2 {
 		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
 		class BaseImage : public BaseFrame<ReaderType, FrameType>, public ofBaseHasTexture, public ofBaseHasPixels_<PixelType>, public ofBaseDraws {
 		public:
+			typedef Threading::Subscription<Data::Frame<PixelType>> FrameSubscription;
+
 			BaseImage();
 
 			//ofBaseHasTexture
@@ -58,17 +66,52 @@ namespace ofxKinectForWindows2 {
 			float getVerticalFieldOfView() const;
 
 			void drawFrustum() const;
+
+			// Use pixels from elsewhere than the reader as the new frame (e.g. received by Network::Client)
+			void loadFrame(const ofPixels_<PixelType> &, INT64 relativeTime = 0);
+			// Sensor time of the latest frame (100ns ticks)
+			INT64 getRelativeTime() const;
+
+			// Also publish each frame as an immutable Data::Frame (off by default), to hand frames to other
+			// threads without copying. Costs one copy of the pixels per frame into a pooled buffer.
+			void setFramesEnabled(bool);
+			bool getFramesEnabled() const;
+			// The latest frame, or nullptr if frames are disabled. Safe to call from any thread.
+			std::shared_ptr<const Data::Frame<PixelType>> getFrame() const;
+			Data::FramePool<PixelType> & getFramePool();
+
+			// Calls back with each new frame on the executor's threads instead of in update(), e.g. to run independent
+			// analyses on separate cores. Enables frames. Call from the thread which updates the source, and
+			// cancel() the subscription to stop.
+			std::shared_ptr<FrameSubscription> onFrame(const typename FrameSubscription::Callback &
+				, Threading::Executor & = Threading::Executor::getDefault()
+				, typename FrameSubscription::Policy = FrameSubscription::DropIfBusy);
 		protected:
+			// Called when the pixels hold a new frame. Uploads them to the texture by default.
+			virtual void pixelsUpdated();
+			// Called after pixelsUpdated()
+			void publishFrame(INT64 relativeTime);
+			// Points the pixels at a pooled buffer if their size changed, and allocates the texture if it's in use and
+			// doesn't match. Cheap to call every frame.
+			void allocatePixels(int width, int height, ofPixelFormat);
+
 			static ofMesh frustumMesh;
 
 			bool useTexture;
 			ofTexture texture;
 			ofPixels_<PixelType> pixels;
+			Data::PooledPixels<PixelType> pixelsStorage;
 
 			float diagonalFieldOfView;
 			float horizontalFieldOfView;
 			float verticalFieldOfView;
-			long  lastFrameTime;
+			INT64 lastFrameTime;
+
+			bool framesEnabled;
+			Data::FramePool<PixelType> framePool;
+			std::shared_ptr<const Data::Frame<PixelType>> frame;
+			uint64_t frameCount;
+			Threading::SubscriptionList<Data::Frame<PixelType>> frameSubscriptions;
 		};
 
 		template OFXKFW2_BaseImageSimple_TEMPLATE_ARGS
@@ -48,11 +48,16 @@ namespace ofxKinectForWindows2 {
 			try {
 				BaseFrame::init(sensor, reader);
 
-				if (FAILED(sensor->get_CoordinateMapper(&this->coordinateMapper))) {
+				// without a sensor (remote device) there is no coordinate mapper, frames arrive through update(const RawFrame &)
+				this->coordinateMapper = nullptr;
+				if (sensor && FAILED(sensor->get_CoordinateMapper(&this->coordinateMapper))) {
 					throw(Exception("Failed to acquire coordinate mapper"));
 				}
 
 				bodies.resize(BODY_COUNT);
+				sampledBodies.resize(BODY_COUNT);
+				trackedBodyIds.reserve(BODY_COUNT);
+				memset(frameJointPositions, 0, sizeof(frameJointPositions));
 
 				useGestures = false;
 
@@ -64,25 +69,25 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		bool Body::getGestureReaderPausedState(int body_index) {
-			BOOLEAN state = false;
-
-			if (useGestures) {
-				if ( FAILED( pGestureReader[body_index]->get_IsPaused(&state) ) ) {
-					throw Exception("Failed to get gesture reading paused state");
-					return false;
-				}
-			}
-
-			return state;
+			// cached from setGestureReaderPausedState, saves a COM call
+			return useGestures ? gesture_reader_paused[body_index] : false;
 		}
 
+		//----------
 		void Body::setGestureReaderPausedState(int body_index, bool state) {
 
+			if (gesture_reader_paused[body_index] == state) {
+				return;
+			}
+
+			// only cache the state once the reader has taken it, so a failed call is retried next time
 			if (FAILED(pGestureReader[body_index]->put_IsPaused(state))) {
 				throw Exception("Failed to set gesture reading paused state");
 				return;
 			}
 
+			gesture_reader_paused[body_index] = state;
+
 			if(!state) gesture_last_unpause_times[body_index] = ofGetFrameNum();
 
 		}
@@ -112,7 +117,10 @@ namespace ofxKinectForWindows2 {
 					}
 
 					gesture_last_unpause_times[i] = 0; // this will get set to framenum if setGestureReaderPausedState
+					gesture_tracking_ids[i] = 0;
+					gesture_stats[i] = GestureStats();
 
+					gesture_reader_paused[i] = false; // readers start unpaused, make sure the call goes through
 					setGestureReaderPausedState(i, true);
 				}
 
@@ -123,6 +131,8 @@ namespace ofxKinectForWindows2 {
 
 				// Setup the gesture_states with default empty states
 				gesture_states.resize(BODY_COUNT);
+				gesture_active.assign(BODY_COUNT, vector<bool>(gesture_count, false));
+				gesture_event_values.assign(BODY_COUNT, vector<float>(gesture_count, 0.0f));
 
 				for (int b = 0; b < BODY_COUNT; b++) {
 					for (int g = 0; g<gesture_count; g++) {
@@ -207,7 +217,8 @@ namespace ofxKinectForWindows2 {
 			this->isFrameNewFlag = true;
 			IFrameDescription * frameDescription = NULL;
 
-			vector<int> tracked_body_ids;
+			auto & tracked_body_ids = this->trackedBodyIds;
+			tracked_body_ids.clear();
 
 			try {
 
@@ -216,6 +227,9 @@ namespace ofxKinectForWindows2 {
 					throw Exception("Failed to get relative time");
 				}
 
+				this->frameRelativeTime = nTime;
+				this->updateHostClockOffset(nTime);
+
 				if (FAILED(frame->get_FloorClipPlane(&floorClipPlane))) {
 					throw(Exception("Failed to get floor clip plane"));
 				}
@@ -227,6 +241,10 @@ namespace ofxKinectForWindows2 {
 
 				//bool found_valid_body = false;
 
+				for (int i = 0; i < BODY_COUNT; ++i) {
+					this->frameTrackingIds[i] = 0;
+				}
+
 				for (int i = 0; i < BODY_COUNT; ++i) {
 
 					// if (found_valid_body) break; //test already found a body lets see if the gesture bug occurs still
@@ -259,10 +277,11 @@ namespace ofxKinectForWindows2 {
 							}
 
 							body.trackingId = trackingId;
+							this->frameTrackingIds[i] = trackingId;
 
 							// Retrieve joint position & orientation
-							_Joint joints[JointType_Count];
-							_JointOrientation jointsOrient[JointType_Count];
+							_Joint * joints = this->frameJoints + i * JointType_Count;
+							_JointOrientation * jointsOrient = this->frameJointOrientations + i * JointType_Count;
 
 							if (FAILED(pBody->GetJoints(JointType_Count, joints))) {
 								throw Exception("Failed to get joints");
@@ -271,10 +290,6 @@ namespace ofxKinectForWindows2 {
 								throw Exception("Failed to get joints orientation");
 							}
 
-							for (int j = 0; j < JointType_Count; ++j) {
-								body.joints[joints[j].JointType] = Data::Joint(joints[j], jointsOrient[j], this->getCoordinateMapper());
-							}
-
 							// Retrieve hand states
 							HandState leftHandState = HandState_Unknown;
 							HandState rightHandState = HandState_Unknown;
@@ -296,7 +311,11 @@ namespace ofxKinectForWindows2 {
 							if (useGestures) {
 								// Make sure untracked bodies have Gesture readers pause
 								setGestureReaderPausedState(i, true);
-								pGestureSource[i]->put_TrackingId(0); // saftey 0 tracking id.								
+								endGestures(i);
+								if (gesture_tracking_ids[i] != 0) {
+									pGestureSource[i]->put_TrackingId(0); // saftey 0 tracking id.
+									gesture_tracking_ids[i] = 0;
+								}
 							}
 
 						}
@@ -307,6 +326,32 @@ namespace ofxKinectForWindows2 {
 				for (int i = 0; i < _countof(ppBodies); ++i) {
 					SafeRelease(ppBodies[i]);
 				}
+
+				// Smooth all bodies together
+				this->bodyFilter.apply(this->frameJoints, this->frameJointOrientations, this->frameTrackingIds, nTime);
+
+				// Map all joints of all tracked bodies into depth space in one call
+				for (auto i : tracked_body_ids) {
+					for (int j = 0; j < JointType_Count; ++j) {
+						this->frameJointPositions[i * JointType_Count + j] = this->frameJoints[i * JointType_Count + j].Position;
+					}
+				}
+				if (!tracked_body_ids.empty()) {
+					if (FAILED(this->coordinateMapper->MapCameraPointsToDepthSpace(BODY_COUNT * JointType_Count, this->frameJointPositions, BODY_COUNT * JointType_Count, this->frameJointsInDepthMap))) {
+						throw Exception("Failed to map joints to depth space");
+					}
+				}
+
+				for (auto i : tracked_body_ids) {
+					bodies[i].setJoints(this->frameJoints + i * JointType_Count, this->frameJointOrientations + i * JointType_Count, this->frameJointsInDepthMap + i * JointType_Count);
+				}
+
+				this->bodyHistory.add(this->bodies, nTime);
+
+				if (!this->gestureRecognizer.getTemplates().empty()) {
+					this->gestureRecognizer.update(this->bodies);
+				}
+				this->publishFrame();
 			}
 			catch (std::exception & e) {
 				OFXKINECTFORWINDOWS2_ERROR << e.what();
@@ -319,203 +364,379 @@ namespace ofxKinectForWindows2 {
 
 		}
 
-		
 		//----------
-		void Body::processGestures(vector<int> &tracked_body_ids) {
-
-			int tracked_count = tracked_body_ids.size();
-
-			if (tracked_count == 0) return;
-			if (!useGestures) return;
-
-			int gestures_read_for_body = -1;
-			bool canReadGestures = true; 
-
-			vector<int> body_ids_to_process;
+		void Body::getRawFrame(RawFrame & rawFrame) const {
+			rawFrame.relativeTime = this->frameRelativeTime;
+			rawFrame.floorClipPlane = this->floorClipPlane;
+			for (int i = 0; i < BODY_COUNT; i++) {
+				const auto & body = this->bodies[i];
+				rawFrame.tracked[i] = body.tracked;
+				rawFrame.trackingIds[i] = body.tracked ? body.trackingId : 0;
+				rawFrame.leftHandStates[i] = body.leftHandState;
+				rawFrame.rightHandStates[i] = body.rightHandState;
+			}
+			memcpy(rawFrame.joints, this->frameJoints, sizeof(rawFrame.joints));
+			memcpy(rawFrame.jointOrientations, this->frameJointOrientations, sizeof(rawFrame.jointOrientations));
+			memcpy(rawFrame.jointsInDepthMap, this->frameJointsInDepthMap, sizeof(rawFrame.jointsInDepthMap));
+		}
 
-			int closest_body_id = -1;
-			float closest_z = 10000;
+		//----------
+		void Body::update(const RawFrame & rawFrame) {
+			this->isFrameNewFlag = true;
+			this->frameRelativeTime = rawFrame.relativeTime;
+			this->updateHostClockOffset(rawFrame.relativeTime);
+			this->floorClipPlane = rawFrame.floorClipPlane;
+
+			memcpy(this->frameJoints, rawFrame.joints, sizeof(this->frameJoints));
+			memcpy(this->frameJointOrientations, rawFrame.jointOrientations, sizeof(this->frameJointOrientations));
+			memcpy(this->frameJointsInDepthMap, rawFrame.jointsInDepthMap, sizeof(this->frameJointsInDepthMap));
+
+			this->trackedBodyIds.clear();
+			for (int i = 0; i < BODY_COUNT; i++) {
+				auto & body = this->bodies[i];
+				body.clear();
+				body.bodyId = i;
+				body.tracked = rawFrame.tracked[i] != 0;
+				this->frameTrackingIds[i] = 0;
+				if (body.tracked) {
+					body.trackingId = rawFrame.trackingIds[i];
+					body.leftHandState = rawFrame.leftHandStates[i];
+					body.rightHandState = rawFrame.rightHandStates[i];
+					this->frameTrackingIds[i] = rawFrame.trackingIds[i];
+					this->trackedBodyIds.push_back(i);
+				}
+			}
 
-			for (int i = 0; i < tracked_count; i++) {
-				int b = tracked_body_ids[i];
-				auto & body = bodies[b];
+			this->bodyFilter.apply(this->frameJoints, this->frameJointOrientations, this->frameTrackingIds, rawFrame.relativeTime);
+			for (auto i : this->trackedBodyIds) {
+				this->bodies[i].setJoints(this->frameJoints + i * JointType_Count, this->frameJointOrientations + i * JointType_Count, this->frameJointsInDepthMap + i * JointType_Count);
+			}
 
-				// Make sure all are paused
-				setGestureReaderPausedState(b, true);
+			this->bodyHistory.add(this->bodies, rawFrame.relativeTime);
+			if (!this->gestureRecognizer.getTemplates().empty()) {
+				this->gestureRecognizer.update(this->bodies);
+			}
+			this->publishFrame();
+		}
 
-				ofVec3f pos = body.joints[JointType_Neck].getPosition();
+		//----------
+		shared_ptr<Body::FrameSubscription> Body::onFrame(const FrameSubscription::Callback & callback, Threading::Executor & executor, FrameSubscription::Policy policy) {
+			return this->frameSubscriptions.add(callback, executor, policy);
+		}
 
-				if (useGesturesDetectionZone) {
+		//----------
+		void Body::publishFrame() {
+			if (this->frameSubscriptions.empty()) {
+				return;
+			}
+			auto frame = make_shared<Frame>();
+			frame->relativeTime = this->frameRelativeTime;
+			frame->floorClipPlane = this->floorClipPlane;
+			frame->bodies = this->bodies;
+			this->frameSubscriptions.post(frame);
+		}
 
-					// Is the body in our zone?
-					bool inZone = (pos.x >= gz_min_x) && (pos.x <= gz_max_x) && (pos.z >= gz_min_z) && (pos.z <= gz_max_z);
+		//----------
+		void Body::updateHostClockOffset(INT64 relativeTime) {
+			// Track the offset between the sensor and host clocks. The smallest offset seen is the
+			// one with the least delivery delay, but let it creep up slowly to follow clock drift.
+			INT64 offset = (INT64) ofGetElapsedTimeMicros() * 10 - relativeTime;
+			if (!this->hostClockOffsetValid || offset < this->hostClockOffset) {
+				this->hostClockOffset = offset;
+				this->hostClockOffsetValid = true;
+			}
+			else {
+				this->hostClockOffset += (offset - this->hostClockOffset) / 1000;
+			}
+		}
 
-					if (inZone) {
-						// Valid, lets add it to the closest z to sensor test.
-						if (pos.z < closest_z) {
-							closest_z = pos.z;
-							closest_body_id = b;
-						}
-					}
+		//----------
+		INT64 Body::getRelativeTime(uint64_t hostTimeMicros) const {
+			return (INT64) hostTimeMicros * 10 - this->hostClockOffset;
+		}
 
-				}
-				else {
-					// Test closeness to a sensor as default way of filtering to 1 body for gesture updating
-					if (pos.z < closest_z) {
-						closest_z = pos.z;
-						closest_body_id = b;
-					}
-				}
-				 
-				// if(i == 0) body_ids_to_process.push_back(b);
+		//----------
+		bool Body::getBodyAtTime(int bodyIndex, uint64_t hostTimeMicros, Data::Body & result, Processing::BodyHistory::Extrapolation extrapolation) const {
+			const auto & body = this->bodies[bodyIndex];
+			result = body;
+			if (!body.tracked || !this->hostClockOffsetValid) {
+				return false;
+			}
+			return this->bodyHistory.sample(bodyIndex, this->getRelativeTime(hostTimeMicros), result, extrapolation, (INT64) (this->maxExtrapolation * 10000000.0f));
+		}
 
+		//----------
+		const vector<Data::Body> & Body::getBodiesAtTime(uint64_t hostTimeMicros, Processing::BodyHistory::Extrapolation extrapolation) {
+			for (int i = 0; i < (int) this->bodies.size(); i++) {
+				this->getBodyAtTime(i, hostTimeMicros, this->sampledBodies[i], extrapolation);
 			}
+			return this->sampledBodies;
+		}
 
-			if (closest_body_id == -1) return; // did not find anyone in zone?
+		//----------
+		const vector<Data::Body> & Body::getBodiesNow(Processing::BodyHistory::Extrapolation extrapolation) {
+			return this->getBodiesAtTime(ofGetElapsedTimeMicros() + (uint64_t) (this->latencyCompensation * 1000000.0f), extrapolation);
+		}
 
-			body_ids_to_process.push_back(closest_body_id);
+		//----------
+		void Body::setGestureSchedule(GestureSchedule gestureSchedule) {
+			this->gestureSchedule = gestureSchedule;
+		}
 
-			int process_count = body_ids_to_process.size();
+		//----------
+		Body::GestureSchedule Body::getGestureSchedule() const {
+			return this->gestureSchedule;
+		}
 
-			for (int j = 0; j < process_count; j++) {
+		//----------
+		void Body::setGestureTimeBudget(float milliseconds) {
+			this->gestureTimeBudget = milliseconds;
+		}
 
-				int b = body_ids_to_process[j];
-				auto & body = bodies[b];
+		//----------
+		float Body::getGestureTimeBudget() const {
+			return this->gestureTimeBudget;
+		}
 
-				UINT64 gestureTrackingId;
+		//----------
+		const GestureStats & Body::getGestureStats(int body_index) const {
+			return this->gesture_stats[body_index];
+		}
 
-				if (FAILED(pGestureSource[b]->get_TrackingId(&gestureTrackingId))) {
-					throw Exception("Failed to get gesture source tracking id");
-				}
+		//----------
+		void Body::processGestures(vector<int> &tracked_body_ids) {
 
-				if (gestureTrackingId != body.trackingId) {
+			int tracked_count = tracked_body_ids.size();
 
-					// Update the corresponding gesture detector with the new value
-					pGestureSource[b]->put_TrackingId(body.trackingId);
+			if (tracked_count == 0) return;
+			if (!useGestures) return;
 
-					// From the DiscreteGestureBasics-WPF file.
-					// if the current body is tracked, unpause its detector to get VisualGestureBuilderFrameArrived events
-					// if the current body is not tracked, pause its detector so we don't waste resources trying to get invalid gesture results
-					//  this.gestureDetectorList[i].IsPaused = trackingId == 0; // c# ref. code.
+			// Gather candidates (tracked bodies inside the zone if we're using one)
+			int candidates[BODY_COUNT];
+			float candidate_z[BODY_COUNT];
+			int candidate_count = 0;
 
-					/*if (body.trackingId == 0) {
+			for (int i = 0; i < tracked_count; i++) {
+				int b = tracked_body_ids[i];
+				const ofVec3f & pos = bodies[b].jointArrays.positions[JointType_Neck];
+
+				if (useGesturesDetectionZone) {
+					// Is the body in our zone?
+					bool inZone = (pos.x >= gz_min_x) && (pos.x <= gz_max_x) && (pos.z >= gz_min_z) && (pos.z <= gz_max_z);
+					if (!inZone) {
 						setGestureReaderPausedState(b, true);
+						endGestures(b);
+						continue;
 					}
-					else {
-						// Only unpause if valid trackingId and canRead
-					//	setGestureReaderPausedState(i, !canReadGestures);
-					}*/
-
 				}
 
-				canReadGestures = (gestures_read_for_body == -1); // && (ofGetFrameNum() - gesture_last_unpause_times[b] > 1);
-
-				if (canReadGestures) {
-					// unpause
-					setGestureReaderPausedState(b, false);
-				}
+				candidates[candidate_count] = b;
+				candidate_z[candidate_count] = pos.z;
+				candidate_count++;
+			}
 
-				/*BOOLEAN reading_paused = true;
+			if (candidate_count == 0) return; // did not find anyone in zone?
 
-				if ((FAILED(pGestureReader[i]->get_IsPaused(&reading_paused))))	 {
-					throw Exception("Failed to get gesture reading paused state");
+			// Order the candidates
+			switch (gestureSchedule) {
+			case GestureSchedule_ClosestBody:
+			case GestureSchedule_Priority:
+			{
+				// Closest to the sensor first (insertion sort, at most BODY_COUNT entries)
+				for (int i = 1; i < candidate_count; i++) {
+					for (int j = i; j > 0 && candidate_z[j] < candidate_z[j - 1]; j--) {
+						std::swap(candidates[j], candidates[j - 1]);
+						std::swap(candidate_z[j], candidate_z[j - 1]);
+					}
 				}
-				if (reading_paused) {
-					pGestureReader[i]->put_IsPaused(false);
-					//pGestureSource[i]->put_TrackingId(trackingId);
-				}*/
-
-				if (canReadGestures) {
+				break;
+			}
+			case GestureSchedule_RoundRobin:
+			{
+				// Start from the first body at or after the one we reached last frame
+				int start = 0;
+				for (int i = 0; i < candidate_count; i++) {
+					if (candidates[i] >= gesture_round_robin_next) {
+						start = i;
+						break;
+					}
+				}
+				std::rotate(candidates, candidates + start, candidates + candidate_count);
+				break;
+			}
+			}
 
-					//gestures_read_for_body = b;
+			if (gestureSchedule == GestureSchedule_ClosestBody) {
+				// Only the closest body's reader runs, pause the rest
+				for (int i = 1; i < candidate_count; i++) {
+					setGestureReaderPausedState(candidates[i], true);
+					endGestures(candidates[i]);
+				}
+				candidate_count = 1;
+			}
 
-					IVisualGestureBuilderFrame* pGestureFrame = nullptr;
+			// Evaluate as many bodies as fit in the time budget (always at least one)
+			auto start_time = ofGetElapsedTimeMicros();
+			const uint64_t budget = (uint64_t) (gestureTimeBudget * 1000.0f);
 
-					if ( SUCCEEDED( pGestureReader[b]->CalculateAndAcquireLatestFrame(&pGestureFrame) ) ) {
-						BOOLEAN bGestureTracked = false;
-						if ( FAILED( pGestureFrame->get_IsTrackingIdValid(&bGestureTracked) ) ) {
-							throw Exception("failed to retrieve tracking id validity");
-						}
+			for (int i = 0; i < candidate_count; i++) {
+				int b = candidates[i];
 
-						// Extra sanity check for the multiple body gesture noise errors.
-						/*BOOLEAN bFrameSourceActive = false;
-						if ( FAILED(pGestureSource[i]->get_IsActive(&bFrameSourceActive)) ) {
-							throw Exception("failed to retrieve frame source active");
-						}*/
+				if (i > 0 && gestureSchedule != GestureSchedule_ClosestBody && ofGetElapsedTimeMicros() - start_time > budget) {
+					// Out of time, continue from here next frame
+					gesture_round_robin_next = b;
+					return;
+				}
 
-						if (bGestureTracked) { // && bFrameSourceActive
+				evaluateGestures(b);
+			}
 
-							IDiscreteGestureResult* pGestureResult = nullptr;
-							IContinuousGestureResult* pContinuousGestureResult = nullptr;
+			gesture_round_robin_next = (candidates[candidate_count - 1] + 1) % BODY_COUNT;
+		}
 
-							for (int g = 0; g < pGesture.size(); g++) {
+		//----------
+		void Body::evaluateGestures(int b) {
+			auto & body = bodies[b];
+			auto start_time = ofGetElapsedTimeMicros();
+
+			// Update the corresponding gesture detector with the new value
+			if (gesture_tracking_ids[b] != body.trackingId) {
+				endGestures(b);
+				if (FAILED(pGestureSource[b]->put_TrackingId(body.trackingId))) {
+					throw Exception("Failed to set gesture source tracking id");
+				}
+				gesture_tracking_ids[b] = body.trackingId;
+			}
 
-								// TODO: Could save looking up type everytime by reading gesture_states[i][g].continuous
+			// No-op if already running
+			setGestureReaderPausedState(b, false);
 
-								GestureType gestureType;
-								pGesture[g]->get_GestureType(&gestureType);
+			IVisualGestureBuilderFrame* pGestureFrame = nullptr;
 
-								if (gestureType == GestureType::GestureType_Continuous) {
+			if ( SUCCEEDED( pGestureReader[b]->CalculateAndAcquireLatestFrame(&pGestureFrame) ) ) {
+				BOOLEAN bGestureTracked = false;
+				if ( FAILED( pGestureFrame->get_IsTrackingIdValid(&bGestureTracked) ) ) {
+					SafeRelease(pGestureFrame);
+					throw Exception("failed to retrieve tracking id validity");
+				}
 
-									if ( SUCCEEDED( pGestureFrame->get_ContinuousGestureResult(pGesture[g], &pContinuousGestureResult) ) ) {
+				if (bGestureTracked) {
 
-										float progress;
-										pContinuousGestureResult->get_Progress(&progress);
-										gesture_states[b][g].detected = true;
-										gesture_states[b][g].value = progress;
-										gesture_states[b][g].update_time = ofGetElapsedTimeMillis();
+					for (int g = 0; g < pGesture.size(); g++) {
+						auto & state = gesture_states[b][g];
 
-										//UINT64 num;
-										//pGestureFrame->get_TrackingId(&num);
-										//ofLog(OF_LOG_VERBOSE, "gesture:" + ofToString(g) + ", id:" + ofToString(num));
-									}
-									SafeRelease(pContinuousGestureResult);
-								}
-								else if (gestureType == GestureType::GestureType_Discrete) {
+						if (state.continuous) {
+							IContinuousGestureResult* pContinuousGestureResult = nullptr;
 
-									if ( SUCCEEDED( pGestureFrame->get_DiscreteGestureResult(pGesture[g], &pGestureResult) ) ) {
+							if ( SUCCEEDED( pGestureFrame->get_ContinuousGestureResult(pGesture[g], &pContinuousGestureResult) ) && pContinuousGestureResult != NULL) {
 
-										// TODO: For noise issue - Do some extra saftey tests here that this result is connected to the same body/gesture? -> pGestureFrame->get_TrackingId(&num);
-												
-										if (pGestureResult != NULL) {
+								float progress;
+								pContinuousGestureResult->get_Progress(&progress);
+								state.detected = true;
+								state.value = progress;
+								state.update_time = ofGetElapsedTimeMillis();
+							}
+							SafeRelease(pContinuousGestureResult);
+						}
+						else {
+							IDiscreteGestureResult* pGestureResult = nullptr;
 
-											if (FAILED(pGestureResult->get_Detected(&gesture_states[b][g].detected))) {
-												throw Exception("Failed to get discrete gesture detected");
-											}
+							if ( SUCCEEDED( pGestureFrame->get_DiscreteGestureResult(pGesture[g], &pGestureResult) ) && pGestureResult != NULL) {
 
-											gesture_states[b][g].update_time = ofGetElapsedTimeMillis();
+								if (FAILED(pGestureResult->get_Detected(&state.detected))) {
+									SafeRelease(pGestureResult);
+									SafeRelease(pGestureFrame);
+									throw Exception("Failed to get discrete gesture detected");
+								}
 
-											if (gesture_states[b][g].detected) {
+								state.update_time = ofGetElapsedTimeMillis();
 
-												if (FAILED(pGestureResult->get_FirstFrameDetected(&gesture_states[b][g].firstFrameDetected))) {
-													throw Exception("Failed to get discrete gesture firstframe detected");
-												}
+								if (state.detected) {
 
-												if (FAILED(pGestureResult->get_Confidence(&gesture_states[b][g].value))) {
-													throw Exception("Failed to get discrete gesture confidence");
-												}
+									if (FAILED(pGestureResult->get_FirstFrameDetected(&state.firstFrameDetected))) {
+										SafeRelease(pGestureResult);
+										SafeRelease(pGestureFrame);
+										throw Exception("Failed to get discrete gesture firstframe detected");
+									}
 
-												//UINT64 num;
-												//pGestureFrame->get_TrackingId(&num);
-												//ofLogVerbose() << "body:" << gesture_states[b][g].body << "," << b << ", gesture:" << gesture_states[b][g].id << "," << g << ", name:'" << gesture_states[b][g].name << "', confidence:" + ofToString(confidence,2) + ", tracking-id:"  << num;
-											}
-										}
+									if (FAILED(pGestureResult->get_Confidence(&state.value))) {
+										SafeRelease(pGestureResult);
+										SafeRelease(pGestureFrame);
+										throw Exception("Failed to get discrete gesture confidence");
 									}
 								}
 							}
 							SafeRelease(pGestureResult);
 						}
-					}
-					SafeRelease(pGestureFrame);
 
+						// Edge triggered events
+						if (gestureEventsEnabled) {
+							bool active = state.continuous ? (state.detected && state.value > gestureEventContinuousThreshold) : (bool) state.detected;
+							bool wasActive = gesture_active[b][g];
+							if (active && !wasActive) {
+								emitGestureEvent(GestureEvent::Began, b, g, state.value);
+							}
+							else if (active && fabs(state.value - gesture_event_values[b][g]) >= gestureEventMinimumChange) {
+								emitGestureEvent(GestureEvent::Progressed, b, g, state.value);
+							}
+							else if (!active && wasActive) {
+								emitGestureEvent(GestureEvent::Ended, b, g, state.value);
+							}
+							gesture_active[b][g] = active;
+						}
+					}
 				}
 				else {
-					// make sure its paused.
-					setGestureReaderPausedState(b, true);
+					endGestures(b);
 				}
+			}
+			SafeRelease(pGestureFrame);
+
+			// Stats
+			auto end_time = ofGetElapsedTimeMicros();
+			auto & stats = gesture_stats[b];
+			stats.evaluationDuration = (float) (end_time - start_time);
+			if (stats.lastEvaluationTime != 0) {
+				stats.latency = (float) (end_time - stats.lastEvaluationTime) / 1000.0f;
+			}
+			stats.lastEvaluationTime = end_time;
+			stats.evaluationCount++;
+		}
 
+		//----------
+		bool Body::popGestureEvent(GestureEvent & event) {
+			return gestureEvents.pop(event);
+		}
+
+		//----------
+		void Body::emitGestureEvent(GestureEvent::Type type, int body_index, int gesture_index, float value) {
+			GestureEvent event;
+			event.type = type;
+			event.body = body_index;
+			event.gesture = gesture_index;
+			event.trackingId = gesture_tracking_ids[body_index];
+			event.continuous = gesture_states[body_index][gesture_index].continuous;
+			event.value = value;
+			event.time = ofGetElapsedTimeMicros();
+
+			if (!gestureEvents.pushDropOldest(event)) {
+				droppedGestureEventCount++;
 			}
+			gesture_event_values[body_index][gesture_index] = value;
+		}
 
+		//----------
+		void Body::endGestures(int body_index) {
+			if (!gestureEventsEnabled || gesture_active.empty()) {
+				return;
+			}
+			auto & active = gesture_active[body_index];
+			for (int g = 0; g < (int) active.size(); g++) {
+				if (active[g]) {
+					emitGestureEvent(GestureEvent::Ended, body_index, g, 0.0f);
+					active[g] = false;
+				}
+			}
 		}
 
 		//----------
@@ -524,6 +745,10 @@ namespace ofxKinectForWindows2 {
 
 			const auto & body = bodies[bodyIdx];
 			if (!body.tracked) return result;
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (projections need a local sensor)";
+				return result;
+			}
 
 			for (auto & joint : body.joints) {
 				ofVec2f & position = result[joint.second.getType()] = ofVec2f();
@@ -541,6 +766,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Body::drawProjected(int x, int y, int width, int height, ProjectionCoordinates proj) {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (projections need a local sensor)";
+				return;
+			}
 			ofPushStyle();
 			int w, h;
 			switch (proj) {
@@ -553,7 +782,9 @@ namespace ofxKinectForWindows2 {
 			for (auto & body : bodies) {
 				if (!body.tracked) continue;
 
-				map<JointType, ofVec2f> jntsProj;
+				ofVec2f jntsProj[JointType_Count];
+				TrackingState trackingStates[JointType_Count];
+				std::fill(trackingStates, trackingStates + JointType_Count, TrackingState_NotTracked);
 
 				ofColor bone_col = getColor(body.bodyId);
 				// joint colour? a darker variant of the bone_col?
@@ -561,9 +792,10 @@ namespace ofxKinectForWindows2 {
 				//joint_col.setBrightness(.75); // darker variant
 
 				for (auto & j : body.joints) {
-					ofVec2f & p = jntsProj[j.second.getType()] = ofVec2f();
+					ofVec2f & p = jntsProj[j.second.getType()];
 
 					TrackingState state = j.second.getTrackingState();
+					trackingStates[j.second.getType()] = state;
 					if (state == TrackingState_NotTracked) continue;
 
 					p.set(j.second.getProjected(coordinateMapper, proj));
@@ -576,7 +808,7 @@ namespace ofxKinectForWindows2 {
 				}
 				
 				for (auto & bone : bonesAtlas) {
-					drawProjectedBone(body.joints, jntsProj, bone.first, bone.second, bone_col);
+					drawProjectedBone(trackingStates, jntsProj, bone.first, bone.second, bone_col);
 				}
 
 				drawProjectedHand(body.leftHandState, jntsProj[JointType_HandLeft]);
@@ -659,8 +891,25 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Body::drawProjectedBone(map<JointType, Data::Joint> & pJoints, map<JointType, ofVec2f> & pJointPoints, JointType joint0, JointType joint1, ofColor color){
-			TrackingState ts1 = pJoints[joint0].getTrackingState();
-			TrackingState ts2 = pJoints[joint1].getTrackingState();
+			const TrackingState trackingStates[2] = { pJoints[joint0].getTrackingState(), pJoints[joint1].getTrackingState() };
+			const ofVec2f jointPoints[2] = { pJointPoints[joint0], pJointPoints[joint1] };
+			drawProjectedBone(trackingStates, jointPoints, 0, 1, color);
+		}
+
+		//----------
+		void Body::drawProjectedBone(const Data::JointMap & pJoints, map<JointType, ofVec2f> & pJointPoints, JointType joint0, JointType joint1, ofColor color) {
+			const TrackingState trackingStates[2] = {
+				pJoints.has(joint0) ? pJoints.get(joint0).getTrackingState() : TrackingState_NotTracked,
+				pJoints.has(joint1) ? pJoints.get(joint1).getTrackingState() : TrackingState_NotTracked
+			};
+			const ofVec2f jointPoints[2] = { pJointPoints[joint0], pJointPoints[joint1] };
+			drawProjectedBone(trackingStates, jointPoints, 0, 1, color);
+		}
+
+		//----------
+		void Body::drawProjectedBone(const TrackingState * trackingStates, const ofVec2f * pJointPoints, int joint0, int joint1, ofColor color) {
+			TrackingState ts1 = trackingStates[joint0];
+			TrackingState ts2 = trackingStates[joint1];
 			if (ts1 == TrackingState_NotTracked || ts2 == TrackingState_NotTracked) return;
 			if (ts1 == TrackingState_Inferred && ts2 == TrackingState_Inferred) return;
 
@@ -7,6 +7,11 @@
 
 #include "../Data/Body.h"
 #include "../Data/Joint.h"
+#include "../Processing/BodyFilter.h"
+#include "../Processing/BodyHistory.h"
+#include "../Processing/GestureRecognizer.h"
+#include "../Threading/LockFreeQueue.h"
+#include "../Threading/Subscription.h"
 
 #include <Kinect.VisualGestureBuilder.h>
 
@@ -24,17 +29,78 @@ namespace ofxKinectForWindows2 {
 			string name;
 		};
 
+		// Every Began is matched by an Ended, also when the body stops being evaluated (lost, outside the
+		// detection zone, or paused by the schedule)
+		struct GestureEvent {
+			enum Type {
+				Began,
+				Progressed,
+				Ended
+			};
+			Type type;
+			int body;					// index of body
+			int gesture;				// index of the gesture
+			UINT64 trackingId;
+			bool continuous;
+			float value;				// Confidence or Progress
+			uint64_t time;				// ofGetElapsedTimeMicros() of the evaluation
+		};
+
+		struct GestureStats {
+			float evaluationDuration = 0.0f;	// microseconds spent evaluating this body's gestures last time
+			float latency = 0.0f;				// milliseconds between the last two evaluations of this body
+			uint64_t lastEvaluationTime = 0;	// ofGetElapsedTimeMicros() of the last evaluation
+			uint64_t evaluationCount = 0;
+		};
+
 		// -------
 		class Body : public BaseFrame<IBodyFrameReader, IBodyFrame> {
 
 		public:
+			enum GestureSchedule {
+				GestureSchedule_ClosestBody,	// only evaluate the closest body (in the zone)
+				GestureSchedule_RoundRobin,		// evaluate all bodies, continuing where we left off when out of time
+				GestureSchedule_Priority		// evaluate all bodies closest first until out of time
+			};
+
 			string getTypeName() const override;
 			void init(IKinectSensor *, bool) override;
 			bool initGestures(IKinectSensor *, wstring db_file);
 
+			// Raw joint data of all BODY_COUNT slots for one frame (body major), e.g. to send bodies to another machine
+			struct RawFrame {
+				INT64 relativeTime;
+				Vector4 floorClipPlane;
+				BOOLEAN tracked[BODY_COUNT];
+				UINT64 trackingIds[BODY_COUNT];
+				HandState leftHandStates[BODY_COUNT];
+				HandState rightHandStates[BODY_COUNT];
+				_Joint joints[BODY_COUNT * JointType_Count];
+				_JointOrientation jointOrientations[BODY_COUNT * JointType_Count];
+				DepthSpacePoint jointsInDepthMap[BODY_COUNT * JointType_Count];
+			};
+
 			void update(IBodyFrame *) override;
 			void update(IMultiSourceFrame *) override;
 
+			// Use a frame from elsewhere than the reader (e.g. received by Network::Client)
+			void update(const RawFrame &);
+			void getRawFrame(RawFrame &) const;
+
+			// Snapshot of the bodies of one frame, handed to onFrame subscribers
+			struct Frame {
+				INT64 relativeTime;
+				Vector4 floorClipPlane;
+				vector<Data::Body> bodies;
+			};
+			typedef Threading::Subscription<Frame> FrameSubscription;
+
+			// Calls back with each new frame on the executor's threads instead of in update(). Call from the thread
+			// which updates the source, and cancel() the subscription to stop.
+			shared_ptr<FrameSubscription> onFrame(const FrameSubscription::Callback &
+				, Threading::Executor & = Threading::Executor::getDefault()
+				, FrameSubscription::Policy = FrameSubscription::DropIfBusy);
+
 			void drawProjected(int x, int y, int width, int height, ProjectionCoordinates proj = ColorCamera);
 			void drawWorld( ofColor col = ofColor::black );
 
@@ -51,6 +117,8 @@ namespace ofxKinectForWindows2 {
 			ofMatrix4x4 getFloorTransform();
 
 			static void drawProjectedBone(map<JointType, Data::Joint> & pJoints, map<JointType, ofVec2f> & pJointPoints, JointType joint0, JointType joint1, ofColor color = ofColor::green);
+			static void drawProjectedBone(const Data::JointMap & pJoints, map<JointType, ofVec2f> & pJointPoints, JointType joint0, JointType joint1, ofColor color = ofColor::green);
+			static void drawProjectedBone(const TrackingState * trackingStates, const ofVec2f * pJointPoints, int joint0, int joint1, ofColor color = ofColor::green);
 			static void drawProjectedHand(HandState handState, ofVec2f & handPos);
 
 			// Gestures
@@ -72,6 +140,24 @@ namespace ofxKinectForWindows2 {
 			void setGestureReaderPausedState(int body_index, bool state); 
 
 			void processGestures(vector<int> &tracked_body_ids);
+
+			void setGestureSchedule(GestureSchedule);
+			GestureSchedule getGestureSchedule() const;
+			// Time allowed per frame for evaluating gestures (in RoundRobin and Priority schedules)
+			void setGestureTimeBudget(float milliseconds);
+			float getGestureTimeBudget() const;
+			const GestureStats & getGestureStats(int body_index) const;
+
+			// Gesture events are emitted only when a gesture starts, changes or stops, and can be
+			// popped from any thread. If nobody drains the queue the oldest events are dropped.
+			void setGestureEventsEnabled(bool enabled) { gestureEventsEnabled = enabled; }
+			bool getGestureEventsEnabled() const { return gestureEventsEnabled; }
+			// Continuous gestures count as active above this progress
+			void setGestureEventContinuousThreshold(float threshold) { gestureEventContinuousThreshold = threshold; }
+			// Minimum change of value to emit a Progressed event
+			void setGestureEventMinimumChange(float change) { gestureEventMinimumChange = change; }
+			bool popGestureEvent(GestureEvent &);
+			size_t getDroppedGestureEventCount() const { return droppedGestureEventCount; }
 			
 			const bool &getGestureIsContinuous(int body_index, int n) { return gesture_states[body_index][n].continuous; }
 			const bool &getGestureIsFirstFrameDetected(int body_index, int n) { return gesture_states[body_index][n].firstFrameDetected; }
@@ -83,14 +169,62 @@ namespace ofxKinectForWindows2 {
 
 			const ofColor getColor(int body_index) { return colors[body_index]; }
 
+			// Smoothing applied to joints as they arrive (disabled by default, see BodyFilter::setMode)
+			Processing::BodyFilter & getBodyFilter() { return bodyFilter; }
+
+			// Last frames of each tracked body with joint velocities and accelerations
+			Processing::BodyHistory & getBodyHistory() { return bodyHistory; }
+			const Processing::BodyHistory & getBodyHistory() const { return bodyHistory; }
+
+			// Template matching gestures on joint trajectories, runs only once templates are added.
+			// Matches for the latest frame are in getGestureRecognizer().getMatches()
+			Processing::GestureRecognizer & getGestureRecognizer() { return gestureRecognizer; }
+
+			// Sampling bodies between / ahead of frames. Host times are ofGetElapsedTimeMicros().
+			INT64 getRelativeTime(uint64_t hostTimeMicros) const;
+			bool getBodyAtTime(int bodyIndex, uint64_t hostTimeMicros, Data::Body & result, Processing::BodyHistory::Extrapolation = Processing::BodyHistory::ConstantVelocity) const;
+			const vector<Data::Body> & getBodiesAtTime(uint64_t hostTimeMicros, Processing::BodyHistory::Extrapolation = Processing::BodyHistory::ConstantVelocity);
+			// Bodies resampled at now + latency compensation, for drawing at render rate
+			const vector<Data::Body> & getBodiesNow(Processing::BodyHistory::Extrapolation = Processing::BodyHistory::ConstantVelocity);
+
+			void setLatencyCompensation(float seconds) { latencyCompensation = seconds; }
+			float getLatencyCompensation() const { return latencyCompensation; }
+			void setMaxExtrapolation(float seconds) { maxExtrapolation = seconds; }
+			float getMaxExtrapolation() const { return maxExtrapolation; }
+
 		protected:
 			void initReader(IKinectSensor *) override;
+			void evaluateGestures(int body_index);
+			void emitGestureEvent(GestureEvent::Type, int body_index, int gesture_index, float value);
+			void endGestures(int body_index);
+			void updateHostClockOffset(INT64 relativeTime);
+			void publishFrame();
 
 			ICoordinateMapper * coordinateMapper;
 
 			Vector4 floorClipPlane;
 
 			vector<Data::Body> bodies;
+			vector<int> trackedBodyIds;
+
+			Processing::BodyFilter bodyFilter;
+			Processing::BodyHistory bodyHistory;
+			Processing::GestureRecognizer gestureRecognizer;
+
+			vector<Data::Body> sampledBodies;
+			INT64 frameRelativeTime = 0;
+			Threading::SubscriptionList<Frame> frameSubscriptions;
+			INT64 hostClockOffset = 0; // host time - relative time, in 100ns ticks
+			bool hostClockOffsetValid = false;
+			float latencyCompensation = 0.0f;
+			float maxExtrapolation = 0.1f;
+
+			// Raw data of the current frame for all body slots, body major
+			_Joint frameJoints[BODY_COUNT * JointType_Count];
+			_JointOrientation frameJointOrientations[BODY_COUNT * JointType_Count];
+			UINT64 frameTrackingIds[BODY_COUNT];
+			CameraSpacePoint frameJointPositions[BODY_COUNT * JointType_Count];
+			DepthSpacePoint frameJointsInDepthMap[BODY_COUNT * JointType_Count];
 
 			uint64_t gesture_last_unpause_times[BODY_COUNT];// 
 			vector< vector<GestureState> > gesture_states;
@@ -100,6 +234,21 @@ namespace ofxKinectForWindows2 {
 			IVisualGestureBuilderFrameReader* pGestureReader[BODY_COUNT];
 			bool useGestures;
 
+			GestureSchedule gestureSchedule = GestureSchedule_ClosestBody;
+			float gestureTimeBudget = 2.0f;
+			int gesture_round_robin_next = 0;
+			bool gesture_reader_paused[BODY_COUNT];
+			UINT64 gesture_tracking_ids[BODY_COUNT];
+			GestureStats gesture_stats[BODY_COUNT];
+
+			bool gestureEventsEnabled = true;
+			float gestureEventContinuousThreshold = 0.05f;
+			float gestureEventMinimumChange = 0.01f;
+			Threading::LockFreeQueue<GestureEvent> gestureEvents;
+			vector< vector<bool> > gesture_active; // [body][gesture] active as far as events are concerned
+			vector< vector<float> > gesture_event_values; // [body][gesture] value at the last emitted event
+			size_t droppedGestureEventCount = 0;
+
 			bool useGesturesDetectionZone;
 			float gz_min_x;
 			float gz_max_x;
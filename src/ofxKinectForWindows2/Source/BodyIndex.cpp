@@ -1,8 +1,44 @@
 #include "BodyIndex.h"
 #include "ofMain.h"
 
+#if defined(_M_X64) || defined(__SSE2__)
+#define OFXKFW2_BODYINDEX_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace ofxKinectForWindows2 {
 	namespace Source {
+		//----------
+		static inline int countTrailingZeros(unsigned int word) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, word);
+			return (int) index;
+#elif defined(__GNUC__)
+			return __builtin_ctz(word);
+#else
+			int count = 0;
+			while (!(word & 1)) {
+				word >>= 1;
+				count++;
+			}
+			return count;
+#endif
+		}
+
+		//----------
+		BodyIndex::BodyIndex() {
+			this->frameNumber = 0;
+			this->bodyStatsFrameNumber = 0;
+			this->bodyStatsHaveDepth = false;
+			this->bodyMasksFrameNumber = 0;
+			this->bodyStats.resize(BODY_COUNT);
+		}
+
 		//----------
 		string BodyIndex::getTypeName() const {
 			return "BodyIndex";
@@ -50,5 +86,148 @@ namespace ofxKinectForWindows2 {
 			SafeRelease(reference);
 			SafeRelease(frame);
 		}
+
+		//----------
+		void BodyIndex::pixelsUpdated() {
+			//invalidates the cached stats and masks
+			this->frameNumber++;
+			BaseImageSimple::pixelsUpdated();
+		}
+
+		//----------
+		const vector<BodyIndex::BodyStats> & BodyIndex::getBodyStats() {
+			if (this->bodyStatsFrameNumber != this->frameNumber || this->frameNumber == 0) {
+				this->computeBodyStats(nullptr);
+			}
+			return this->bodyStats;
+		}
+
+		//----------
+		const vector<BodyIndex::BodyStats> & BodyIndex::getBodyStats(const ofShortPixels & depth) {
+			if (depth.getWidth() != this->pixels.getWidth() || depth.getHeight() != this->pixels.getHeight()) {
+				OFXKINECTFORWINDOWS2_WARNING << "Depth frame doesn't match the BodyIndex frame, ignoring depth";
+				return this->getBodyStats();
+			}
+			if (this->bodyStatsFrameNumber != this->frameNumber || !this->bodyStatsHaveDepth || this->frameNumber == 0) {
+				this->computeBodyStats(depth.getData());
+			}
+			return this->bodyStats;
+		}
+
+		//----------
+		const Data::BitMask & BodyIndex::getBodyMask(int bodyIndex) {
+			if (bodyIndex < 0 || bodyIndex >= BODY_COUNT) {
+				throw Exception("Body index out of range");
+			}
+			this->updateBodyMasks();
+			return this->bodyMasks[bodyIndex];
+		}
+
+		//----------
+		const Data::BitMask & BodyIndex::getAnyBodyMask() {
+			this->updateBodyMasks();
+			return this->anyBodyMask;
+		}
+
+		//----------
+		void BodyIndex::updateBodyMasks() {
+			if (this->bodyMasksFrameNumber != this->frameNumber || this->frameNumber == 0) {
+				Data::BitMask::fromBodyIndex(this->pixels, this->bodyMasks, this->anyBodyMask);
+				this->bodyMasksFrameNumber = this->frameNumber;
+			}
+		}
+
+		//----------
+		void BodyIndex::computeBodyStats(const unsigned short * depth) {
+			struct Accumulator {
+				uint64_t count;
+				uint64_t sumX;
+				uint64_t sumY;
+				uint64_t depthSum;
+				uint64_t depthCount;
+				int minX, maxX, minY, maxY;
+			} accumulators[BODY_COUNT];
+
+			for (auto & accumulator : accumulators) {
+				accumulator.count = accumulator.sumX = accumulator.sumY = 0;
+				accumulator.depthSum = accumulator.depthCount = 0;
+				accumulator.minX = accumulator.minY = std::numeric_limits<int>::max();
+				accumulator.maxX = accumulator.maxY = -1;
+			}
+
+			const int width = (int) this->pixels.getWidth();
+			const int height = (int) this->pixels.getHeight();
+			const unsigned char * bodyIndex = this->pixels.getData();
+
+			for (int y = 0; y < height; y++) {
+				const unsigned char * row = bodyIndex + y * width;
+				const unsigned short * depthRow = depth ? depth + y * width : nullptr;
+				auto accumulate = [&](int x) {
+					const unsigned char index = row[x];
+					if (index >= BODY_COUNT) {
+						return;
+					}
+					auto & accumulator = accumulators[index];
+					accumulator.count++;
+					accumulator.sumX += x;
+					accumulator.sumY += y;
+					accumulator.minX = std::min(accumulator.minX, x);
+					accumulator.maxX = std::max(accumulator.maxX, x);
+					accumulator.minY = std::min(accumulator.minY, y);
+					accumulator.maxY = y;
+					if (depthRow && depthRow[x] != 0) {
+						accumulator.depthSum += depthRow[x];
+						accumulator.depthCount++;
+					}
+				};
+				int x = 0;
+
+				//the sums scatter into per body accumulators, so only the background test is vectorized :
+				//blocks of background (255) are skipped, and within a block only the body pixels are visited
+#ifdef OFXKFW2_BODYINDEX_SSE2
+				const __m128i background = _mm_set1_epi8((char) 0xFF);
+				for (; x + 16 <= width; x += 16) {
+					const __m128i pixels = _mm_loadu_si128((const __m128i *) (row + x));
+					unsigned int bodyBits = ~(unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(pixels, background)) & 0xFFFF;
+					while (bodyBits) {
+						accumulate(x + countTrailingZeros(bodyBits));
+						bodyBits &= bodyBits - 1;
+					}
+				}
+#endif
+				for (; x + 8 <= width; x += 8) {
+					uint64_t block;
+					memcpy(&block, row + x, sizeof(block));
+					if (block == ~(uint64_t) 0) {
+						continue;
+					}
+					for (int i = x; i < x + 8; i++) {
+						accumulate(i);
+					}
+				}
+
+				for (; x < width; x++) {
+					accumulate(x);
+				}
+			}
+
+			for (int b = 0; b < BODY_COUNT; b++) {
+				const auto & accumulator = accumulators[b];
+				auto & stats = this->bodyStats[b];
+				stats = BodyStats();
+				stats.pixelCount = (int) accumulator.count;
+				stats.depthCount = (int) accumulator.depthCount;
+				if (accumulator.count > 0) {
+					stats.bounds.set(accumulator.minX, accumulator.minY, accumulator.maxX - accumulator.minX + 1, accumulator.maxY - accumulator.minY + 1);
+					stats.centroid.set((float) accumulator.sumX / (float) accumulator.count, (float) accumulator.sumY / (float) accumulator.count);
+				}
+				if (accumulator.depthCount > 0) {
+					stats.meanDepth = (float) accumulator.depthSum / (float) accumulator.depthCount;
+				}
+			}
+
+			this->bodyStatsFrameNumber = this->frameNumber;
+			this->bodyStatsHaveDepth = depth != nullptr;
+		}
 	}
 }
\ No newline at end of file
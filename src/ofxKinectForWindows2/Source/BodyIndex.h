@@ -1,15 +1,47 @@
 #pragma once
 
 #include "BaseImage.h"
+#include "../Data/BitMask.h"
 
 namespace ofxKinectForWindows2 {
 	namespace Source {
 		class BodyIndex : public BaseImageSimple<unsigned char, IBodyIndexFrameReader, IBodyIndexFrame> {
 		public:
+			struct BodyStats {
+				int pixelCount = 0;
+				ofRectangle bounds; // depth space pixels
+				ofVec2f centroid; // depth space pixels
+				int depthCount = 0; // pixels with a valid depth
+				float meanDepth = 0.0f; // mm, 0 if no depth was given
+			};
+
+			BodyIndex();
+
 			string getTypeName() const override;
 			void update(IMultiSourceFrame *) override;
+
+			// Statistics for each of the BODY_COUNT body indices, computed in a single pass over the frame
+			// (together with the depth frame if given) and cached until the next frame arrives.
+			const vector<BodyStats> & getBodyStats();
+			const vector<BodyStats> & getBodyStats(const ofShortPixels & depth);
+
+			// 1 bit per pixel masks of each body and of any body, cached until the next frame arrives
+			const Data::BitMask & getBodyMask(int bodyIndex);
+			const Data::BitMask & getAnyBodyMask();
 		protected:
 			void initReader(IKinectSensor *) override;
+			void pixelsUpdated() override;
+			void computeBodyStats(const unsigned short * depth);
+			void updateBodyMasks();
+
+			uint64_t frameNumber; // advances with every new frame, whether from the reader or loadFrame
+			uint64_t bodyStatsFrameNumber;
+			bool bodyStatsHaveDepth;
+			vector<BodyStats> bodyStats;
+
+			uint64_t bodyMasksFrameNumber;
+			Data::BitMask bodyMasks[BODY_COUNT];
+			Data::BitMask anyBodyMask;
 		};
 	}
 }
\ No newline at end of file
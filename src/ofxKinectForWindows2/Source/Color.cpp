@@ -48,10 +48,7 @@ namespace ofxKinectForWindows2 {
 				if (FAILED(frameDescription->get_Width(&width)) || FAILED(frameDescription->get_Height(&height))) {
 					throw Exception("Failed to get width and height of frame");
 				}
-				if (width != this->pixels.getWidth() || height != this->texture.getHeight()) {
-					this->pixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
-					this->texture.allocate(this->pixels);
-				}
+				this->allocatePixels(width, height, OF_PIXELS_RGBA);
 
 				//update local rgba image
 				if (this->rgbaPixelsEnabled) {
@@ -65,9 +62,7 @@ namespace ofxKinectForWindows2 {
 
 				//update yuv
 				if (this->yuvPixelsEnabled) {
-					if (width != this->yuvPixels.getWidth() || height != this->yuvPixels.getHeight()) {
-						this->yuvPixels.allocate(width, height, OF_PIXELS_YUY2);
-					}
+					this->yuvPixelsStorage.allocate(this->yuvPixels, width, height, OF_PIXELS_YUY2);
 					if (FAILED(frame->CopyRawFrameDataToArray(this->yuvPixels.size(), this->yuvPixels.getData()))) {
 						throw Exception("Couldn't pull raw YUV pixel buffer");
 					}
@@ -92,6 +87,13 @@ namespace ofxKinectForWindows2 {
 				cameraSettings->get_FrameInterval(&this->frameInterval);
 				cameraSettings->get_Gain(&this->gain);
 				cameraSettings->get_Gamma(&this->gamma);
+
+				INT64 relativeTime = 0;
+				frame->get_RelativeTime(&relativeTime);
+				this->lastFrameTime = relativeTime;
+				if (this->rgbaPixelsEnabled) {
+					this->publishFrame(relativeTime);
+				}
 			} catch (std::exception & e) {
 				OFXKINECTFORWINDOWS2_ERROR << e.what();
 			}
@@ -152,6 +154,9 @@ namespace ofxKinectForWindows2 {
 		//----------
 		void Color::setYuvPixelsEnabled(bool yuvPixelsEnabled) {
 			this->yuvPixelsEnabled = yuvPixelsEnabled;
+			if (!yuvPixelsEnabled) {
+				this->yuvPixelsStorage.release(this->yuvPixels);
+			}
 		}
 
 		//----------
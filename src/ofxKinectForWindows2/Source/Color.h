@@ -38,6 +38,7 @@ namespace ofxKinectForWindows2 {
 			bool rgbaPixelsEnabled = true;
 			bool yuvPixelsEnabled = false;
 			ofPixels yuvPixels;
+			Data::PooledPixels<unsigned char> yuvPixelsStorage;
 		};
 	}
 }
\ No newline at end of file
@@ -50,6 +50,11 @@ namespace ofxKinectForWindows2 {
 			try {
 				BaseFrame::init(sensor, reader);
 
+				// without a sensor (remote device) there is no coordinate mapper, frames arrive through loadFrame
+				this->coordinateMapper = nullptr;
+				if (!sensor) {
+					return;
+				}
 				if (FAILED(sensor->get_CoordinateMapper(&this->coordinateMapper))) {
 					throw(Exception("Failed to acquire coordinate mapper"));
 				}
@@ -101,6 +106,11 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		ofMesh Depth::getMesh(const PointCloudOptions &opts) {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (meshes need a local sensor)";
+				return ofMesh();
+			}
+
 			const int width = this->getWidth();
 			const int height = this->getHeight();
 			const auto frameSize = width * height;
@@ -187,6 +197,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Depth::getWorldInColorFrame(ofFloatPixels & world) const {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (mappings need a local sensor)";
+				return;
+			}
 			world.allocate(this->colorFrameWidth, this->colorFrameHeight, ofPixelFormat::OF_PIXELS_RGB);
 			this->coordinateMapper->MapColorFrameToCameraSpace(
 				this->pixels.size(), this->pixels.getData(),
@@ -195,6 +209,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Depth::getWorldInDepthFrame(ofFloatPixels & world) const {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (mappings need a local sensor)";
+				return;
+			}
 			world.allocate(this->getWidth(), this->getHeight(), ofPixelFormat::OF_PIXELS_RGB);
 			this->coordinateMapper->MapDepthFrameToCameraSpace(
 				this->pixels.size(), this->pixels.getData(),
@@ -203,6 +221,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Depth::getColorInDepthFrameMapping(ofFloatPixels & colorInDepthFrameMapping) const {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (mappings need a local sensor)";
+				return;
+			}
 			colorInDepthFrameMapping.allocate(this->getWidth(), this->getHeight(), OF_PIXELS_RG);
 			this->coordinateMapper->MapDepthFrameToColorSpace(
 				this->pixels.size(), this->pixels.getData(),
@@ -211,6 +233,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Depth::getDepthInColorFrameMapping(ofFloatPixels & depthInColorFrameMapping) const {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (mappings need a local sensor)";
+				return;
+			}
 			depthInColorFrameMapping.allocate(this->colorFrameWidth, this->colorFrameHeight, OF_PIXELS_RG);
 			this->coordinateMapper->MapColorFrameToDepthSpace(
 				this->pixels.size(), this->pixels.getData(),
@@ -219,6 +245,10 @@ namespace ofxKinectForWindows2 {
 
 		//----------
 		void Depth::getDepthToWorldTable(ofFloatPixels & world) const {
+			if (!this->coordinateMapper) {
+				OFXKINECTFORWINDOWS2_ERROR << "No coordinate mapper (mappings need a local sensor)";
+				return;
+			}
 			UINT32 tableEntryCount;
 			PointF * tableEntries;
 			if (FAILED(this->coordinateMapper->GetDepthFrameToCameraSpaceTable(&tableEntryCount, &tableEntries))) {
@@ -236,9 +266,42 @@ namespace ofxKinectForWindows2 {
 			CoTaskMemFree(tableEntries);
 		}
 
+		//----------
+		void Depth::getEncodedPixels(ofPixels & rgb) const {
+			Processing::DepthCodec::encode(this->pixels, rgb);
+		}
+
 		//----------
 		ICoordinateMapper * Depth::getCoordinateMapper() const {
 			return this->coordinateMapper;
 		}
+
+		//----------
+		Processing::DepthColorizer & Depth::getColorizer() {
+			return this->colorizer;
+		}
+
+		//----------
+		const ofPixels & Depth::getColorizedPixels() const {
+			return this->colorizedPixels;
+		}
+
+		//----------
+		void Depth::pixelsUpdated() {
+			//the texture changes format when the colorizer is switched on or off
+			if (!this->colorizer.convert(this->pixels, this->colorizedPixels)) {
+				if (this->useTexture && this->texture.isAllocated() && this->texture.getTextureData().glInternalFormat != ofGetGLInternalFormat(this->pixels)) {
+					this->texture.allocate(this->pixels);
+				}
+				BaseImageSimple::pixelsUpdated();
+				return;
+			}
+			if (this->useTexture) {
+				if (!this->texture.isAllocated() || this->texture.getTextureData().glInternalFormat != ofGetGLInternalFormat(this->colorizedPixels)) {
+					this->texture.allocate(this->colorizedPixels);
+				}
+				this->texture.loadData(this->colorizedPixels);
+			}
+		}
 	}
 }
\ No newline at end of file
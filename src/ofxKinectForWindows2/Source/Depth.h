@@ -1,6 +1,8 @@
 #pragma once
 
 #include "BaseImage.h"
+#include "../Processing/DepthCodec.h"
+#include "../Processing/DepthColorizer.h"
 
 namespace ofxKinectForWindows2 {
 	namespace Source {
@@ -31,21 +33,33 @@ namespace ofxKinectForWindows2 {
 			ofMesh getMesh(bool stitchFaces, PointCloudOptions::TextureCoordinates textureCoordinates);
 			ofVbo getVbo(const PointCloudOptions & pointCloudOptions = PointCloudOptions());
 
+			// The mappings need the sensor's coordinate mapper, so they leave the pixels untouched on a remote device
 			void getWorldInColorFrame(ofFloatPixels & world) const;
 			void getWorldInDepthFrame(ofFloatPixels & world) const;
 			void getColorInDepthFrameMapping(ofFloatPixels & colorInDepthFrameMapping) const;
 			void getDepthInColorFrameMapping(ofFloatPixels & depthInColorFrameMapping) const;
 			void getDepthToWorldTable(ofFloatPixels & world) const;
 
+			// Depth packed into 8 bit RGB for video links, see Processing::DepthCodec (decode with DepthCodec::decode)
+			void getEncodedPixels(ofPixels & rgb) const;
+
 			ICoordinateMapper * getCoordinateMapper() const;
+
+			// False colour output (off by default). When enabled, the texture holds the colorized pixels.
+			Processing::DepthColorizer & getColorizer();
+			const ofPixels & getColorizedPixels() const;
 		protected:
 			void initReader(IKinectSensor *) override;
+			void pixelsUpdated() override;
 
 			ICoordinateMapper * coordinateMapper;
 
 			int colorFrameWidth = 1920;
 			int colorFrameHeight = 1080;
 			int colorFrameSize = colorFrameWidth * colorFrameHeight;
+
+			Processing::DepthColorizer colorizer;
+			ofPixels colorizedPixels;
 		};
 	}
 }
\ No newline at end of file
@@ -49,5 +49,32 @@ namespace ofxKinectForWindows2 {
 			SafeRelease(reference);
 			SafeRelease(frame);
 		}
+
+		//----------
+		Processing::FrameAccumulator & Infrared::getAccumulator() {
+			return this->accumulator;
+		}
+
+		//----------
+		Processing::InfraredConverter & Infrared::getConverter() {
+			return this->converter;
+		}
+
+		//----------
+		const ofPixels & Infrared::getConvertedPixels() const {
+			return this->convertedPixels;
+		}
+
+		//----------
+		void Infrared::pixelsUpdated() {
+			this->accumulator.process(this->pixels);
+			if (!this->converter.convert(this->pixels, this->convertedPixels)) {
+				BaseImageSimple::pixelsUpdated();
+				return;
+			}
+			if (this->useTexture) {
+				this->texture.loadData(this->convertedPixels);
+			}
+		}
 	}
 }
\ No newline at end of file
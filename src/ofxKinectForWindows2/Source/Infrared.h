@@ -1,6 +1,8 @@
 #pragma once
 
 #include "BaseImage.h"
+#include "../Processing/FrameAccumulator.h"
+#include "../Processing/InfraredConverter.h"
 
 namespace ofxKinectForWindows2 {
 	namespace Source {
@@ -9,8 +11,20 @@ namespace ofxKinectForWindows2 {
 			string getTypeName() const override;
 
 			void update(IMultiSourceFrame *) override;
+
+			// Temporal averaging of the pixels (off by default). getPixels() returns the accumulated frame.
+			Processing::FrameAccumulator & getAccumulator();
+
+			// Conversion to 8 bit (off by default). When enabled, the texture holds the converted pixels.
+			Processing::InfraredConverter & getConverter();
+			const ofPixels & getConvertedPixels() const;
 		protected:
 			void initReader(IKinectSensor *) override;
+			void pixelsUpdated() override;
+
+			Processing::FrameAccumulator accumulator;
+			Processing::InfraredConverter converter;
+			ofPixels convertedPixels;
 		};
 	}
 }
\ No newline at end of file
@@ -49,5 +49,32 @@ namespace ofxKinectForWindows2 {
 			SafeRelease(reference);
 			SafeRelease(frame);
 		}
+
+		//----------
+		Processing::FrameAccumulator & LongExposureInfrared::getAccumulator() {
+			return this->accumulator;
+		}
+
+		//----------
+		Processing::InfraredConverter & LongExposureInfrared::getConverter() {
+			return this->converter;
+		}
+
+		//----------
+		const ofPixels & LongExposureInfrared::getConvertedPixels() const {
+			return this->convertedPixels;
+		}
+
+		//----------
+		void LongExposureInfrared::pixelsUpdated() {
+			this->accumulator.process(this->pixels);
+			if (!this->converter.convert(this->pixels, this->convertedPixels)) {
+				BaseImageSimple::pixelsUpdated();
+				return;
+			}
+			if (this->useTexture) {
+				this->texture.loadData(this->convertedPixels);
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Executor.h"
+#include "../Utils.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		//----------
+		Executor::Executor(int threadCount) {
+			this->claimedThreads = threadCount <= 0;
+			if (this->claimedThreads) {
+				threadCount = claimDefaultThreads();
+			}
+
+			this->active = 0;
+			this->exiting = false;
+
+			for (int i = 0; i < threadCount; i++) {
+				this->threads.emplace_back(&Executor::workerLoop, this);
+			}
+		}
+
+		//----------
+		Executor::~Executor() {
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->exiting = true;
+				this->tasks.clear();
+			}
+			this->wake.notify_all();
+			for (auto & thread : this->threads) {
+				thread.join();
+			}
+			if (this->claimedThreads) {
+				releaseDefaultThreads();
+			}
+		}
+
+		//----------
+		Executor & Executor::getDefault() {
+			static Executor executor;
+			return executor;
+		}
+
+		//----------
+		int Executor::getThreadCount() const {
+			return (int) this->threads.size();
+		}
+
+		//----------
+		void Executor::submit(std::function<void()> task) {
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				if (this->exiting) {
+					return;
+				}
+				this->tasks.push_back(std::move(task));
+			}
+			this->wake.notify_one();
+		}
+
+		//----------
+		size_t Executor::getQueueSize() const {
+			std::lock_guard<std::mutex> lock(this->mutex);
+			return this->tasks.size();
+		}
+
+		//----------
+		void Executor::waitIdle() {
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->idle.wait(lock, [this] { return this->tasks.empty() && this->active == 0; });
+		}
+
+		//----------
+		void Executor::workerLoop() {
+			std::unique_lock<std::mutex> lock(this->mutex);
+			for (;;) {
+				this->wake.wait(lock, [this] { return this->exiting || !this->tasks.empty(); });
+				if (this->exiting) {
+					return;
+				}
+
+				auto task = std::move(this->tasks.front());
+				this->tasks.pop_front();
+				this->active++;
+				lock.unlock();
+
+				try {
+					task();
+				}
+				catch (std::exception & e) {
+					OFXKINECTFORWINDOWS2_ERROR << e.what();
+				}
+				catch (...) {
+					//anything else would escape the worker and terminate the app
+					OFXKINECTFORWINDOWS2_ERROR << "Task threw an exception which isn't a std::exception";
+				}
+				task = nullptr; // release captures before reporting idle
+
+				lock.lock();
+				if (--this->active == 0 && this->tasks.empty()) {
+					this->idle.notify_all();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ThreadCount.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// Worker threads running independent tasks in the order they were submitted (e.g. frame callbacks).
+		// Unlike ThreadPool, the caller doesn't wait : submit() returns straight away.
+		class Executor {
+		public:
+			// 0 threads means claimDefaultThreads()
+			Executor(int threadCount = 0);
+			// Tasks not started yet are discarded
+			~Executor();
+
+			// Shared executor for frame callbacks
+			static Executor & getDefault();
+
+			int getThreadCount() const;
+
+			void submit(std::function<void()> task);
+			// Tasks waiting for a thread
+			size_t getQueueSize() const;
+			// Blocks until every submitted task has finished
+			void waitIdle();
+		protected:
+			void workerLoop();
+
+			std::vector<std::thread> threads;
+
+			mutable std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable idle;
+			std::deque<std::function<void()>> tasks;
+			int active;
+			bool exiting;
+			bool claimedThreads;
+		};
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// Bounded multi producer / multi consumer queue without locks (D. Vyukov's design).
+		// Each cell carries a sequence number which tells producers and consumers whose turn it is,
+		// so push and pop are a single compare and swap on the fast path.
+		// Capacity is rounded up to a power of two.
+		template<typename T>
+		class LockFreeQueue {
+		public:
+			LockFreeQueue(size_t capacity = 1024) {
+				size_t size = 2;
+				while (size < capacity) {
+					size <<= 1;
+				}
+				this->cells = std::vector<Cell>(size);
+				this->mask = size - 1;
+				for (size_t i = 0; i < size; i++) {
+					this->cells[i].sequence.store(i, std::memory_order_relaxed);
+				}
+				this->enqueuePosition.store(0, std::memory_order_relaxed);
+				this->dequeuePosition.store(0, std::memory_order_relaxed);
+			}
+
+			// Returns false if the queue is full
+			bool push(const T & value) {
+				Cell * cell;
+				size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+				for (;;) {
+					cell = &this->cells[position & this->mask];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+					if (difference == 0) {
+						if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else if (difference < 0) {
+						return false;
+					}
+					else {
+						position = this->enqueuePosition.load(std::memory_order_relaxed);
+					}
+				}
+				cell->value = value;
+				cell->sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+
+			// Returns false if the queue is empty
+			bool pop(T & value) {
+				Cell * cell;
+				size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+				for (;;) {
+					cell = &this->cells[position & this->mask];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+					if (difference == 0) {
+						if (this->dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else if (difference < 0) {
+						return false;
+					}
+					else {
+						position = this->dequeuePosition.load(std::memory_order_relaxed);
+					}
+				}
+				value = cell->value;
+				cell->sequence.store(position + this->mask + 1, std::memory_order_release);
+				return true;
+			}
+
+			// Push, discarding the oldest entry if the queue is full. Returns false if something was discarded.
+			bool pushDropOldest(const T & value) {
+				bool dropped = false;
+				while (!this->push(value)) {
+					T discard;
+					this->pop(discard);
+					dropped = true;
+				}
+				return !dropped;
+			}
+
+			// Approximate when other threads are pushing or popping
+			size_t size() const {
+				size_t enqueued = this->enqueuePosition.load(std::memory_order_relaxed);
+				size_t dequeued = this->dequeuePosition.load(std::memory_order_relaxed);
+				return enqueued > dequeued ? enqueued - dequeued : 0;
+			}
+
+			bool empty() const {
+				return this->size() == 0;
+			}
+
+			size_t capacity() const {
+				return this->mask + 1;
+			}
+		protected:
+			struct Cell {
+				Cell() : sequence(0) { }
+				Cell(const Cell & other) : sequence(other.sequence.load()), value(other.value) { }
+				std::atomic<size_t> sequence;
+				T value;
+			};
+
+			std::vector<Cell> cells;
+			size_t mask;
+
+			// Separate cache lines so that producers and consumers don't contend
+			char padding0[64];
+			std::atomic<size_t> enqueuePosition;
+			char padding1[64];
+			std::atomic<size_t> dequeuePosition;
+			char padding2[64];
+		};
+	}
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// One subscriber to the frames of a source (see onFrame() of the sources). Its callback runs on an Executor,
+		// never on two threads at once and always in frame order, so callbacks need no locking of their own state.
+		// The Policy decides what happens to frames arriving while the callback is still busy with an earlier one.
+		template<typename FrameType>
+		class Subscription : public std::enable_shared_from_this<Subscription<FrameType>> {
+		public:
+			typedef std::shared_ptr<const FrameType> FramePtr;
+			typedef std::function<void(const FramePtr &)> Callback;
+
+			enum Policy {
+				DropIfBusy,		// skip frames while busy (lowest latency, for analyses which only want the freshest frame)
+				KeepLatest,		// when done, continue with the newest frame that arrived meanwhile
+				Queue			// deliver every frame, dropping the oldest beyond maxQueueSize
+			};
+
+			Subscription(const Callback & callback, Executor & executor, Policy policy, size_t maxQueueSize = 8) :
+				callback(callback),
+				executor(executor),
+				policy(policy),
+				maxQueueSize(std::max<size_t>(maxQueueSize, 1)),
+				scheduled(false),
+				cancelled(false),
+				deliveredCount(0),
+				droppedCount(0) { }
+
+			// No callbacks start after this (one may still be running)
+			void cancel() {
+				this->cancelled = true;
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->pending.clear();
+			}
+			bool isCancelled() const {
+				return this->cancelled;
+			}
+
+			uint64_t getDeliveredCount() const {
+				return this->deliveredCount;
+			}
+			uint64_t getDroppedCount() const {
+				return this->droppedCount;
+			}
+
+			// Called by the source with each new frame
+			void post(const FramePtr & frame) {
+				if (this->cancelled) {
+					return;
+				}
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					if (this->scheduled) {
+						switch (this->policy) {
+						case DropIfBusy:
+							this->droppedCount++;
+							return;
+						case KeepLatest:
+							if (!this->pending.empty()) {
+								this->pending.clear();
+								this->droppedCount++;
+							}
+							break;
+						case Queue:
+							if (this->pending.size() >= this->maxQueueSize) {
+								this->pending.pop_front();
+								this->droppedCount++;
+							}
+							break;
+						}
+						this->pending.push_back(frame);
+						return;
+					}
+					this->pending.push_back(frame);
+					this->scheduled = true;
+				}
+				auto self = this->shared_from_this();
+				this->executor.submit([self] {
+					self->deliver();
+				});
+			}
+		protected:
+			// Runs on the executor until no frames are pending. Only one deliver() is scheduled at a time.
+			// An exception from the callback is passed on to the executor (which logs it), pending frames are still delivered.
+			void deliver() {
+				for (;;) {
+					FramePtr frame;
+					{
+						std::lock_guard<std::mutex> lock(this->mutex);
+						if (this->pending.empty() || this->cancelled) {
+							this->pending.clear();
+							this->scheduled = false;
+							return;
+						}
+						frame = std::move(this->pending.front());
+						this->pending.pop_front();
+					}
+					try {
+						this->callback(frame);
+					}
+					catch (...) {
+						//don't leave the subscription marked as scheduled, continue with the pending frames in a fresh task
+						this->rescheduleAfterThrow();
+						throw;
+					}
+					this->deliveredCount++;
+				}
+			}
+
+			void rescheduleAfterThrow() {
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					if (this->pending.empty() || this->cancelled) {
+						this->pending.clear();
+						this->scheduled = false;
+						return;
+					}
+				}
+				auto self = this->shared_from_this();
+				this->executor.submit([self] {
+					self->deliver();
+				});
+			}
+
+			Callback callback;
+			Executor & executor;
+			const Policy policy;
+			const size_t maxQueueSize;
+
+			std::mutex mutex;
+			std::deque<FramePtr> pending;
+			bool scheduled;
+			std::atomic<bool> cancelled;
+			std::atomic<uint64_t> deliveredCount;
+			std::atomic<uint64_t> droppedCount;
+		};
+
+		// The subscriptions of one source. Only the source's thread posts, subscribers may cancel from anywhere.
+		template<typename FrameType>
+		class SubscriptionList {
+		public:
+			typedef Subscription<FrameType> SubscriptionType;
+
+			~SubscriptionList() {
+				this->clear();
+			}
+
+			std::shared_ptr<SubscriptionType> add(const typename SubscriptionType::Callback & callback, Executor & executor, typename SubscriptionType::Policy policy) {
+				auto subscription = std::make_shared<SubscriptionType>(callback, executor, policy);
+				this->subscriptions.push_back(subscription);
+				return subscription;
+			}
+
+			bool empty() const {
+				return this->subscriptions.empty();
+			}
+
+			void post(const typename SubscriptionType::FramePtr & frame) {
+				for (auto it = this->subscriptions.begin(); it != this->subscriptions.end(); ) {
+					if ((*it)->isCancelled()) {
+						it = this->subscriptions.erase(it);
+					}
+					else {
+						(*it)->post(frame);
+						++it;
+					}
+				}
+			}
+
+			void clear() {
+				for (auto & subscription : this->subscriptions) {
+					subscription->cancel();
+				}
+				this->subscriptions.clear();
+			}
+		protected:
+			std::vector<std::shared_ptr<SubscriptionType>> subscriptions;
+		};
+	}
+}
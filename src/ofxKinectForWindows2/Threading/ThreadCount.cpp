@@ -0,0 +1,39 @@
+#include "ThreadCount.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// 0 until set
+		static std::atomic<int> defaultThreadCount(0);
+		// Executors and WorkStealingPools holding default threads
+		static std::atomic<int> claimCount(0);
+
+		//----------
+		void setDefaultThreadCount(int threadCount) {
+			defaultThreadCount = std::max(threadCount, 1);
+		}
+
+		//----------
+		int getDefaultThreadCount() {
+			const int threadCount = defaultThreadCount;
+			if (threadCount > 0) {
+				return threadCount;
+			}
+			return std::max((int) std::thread::hardware_concurrency() - 1, 1);
+		}
+
+		//----------
+		int claimDefaultThreads() {
+			const int claims = ++claimCount;
+			return std::max(getDefaultThreadCount() / claims, 1);
+		}
+
+		//----------
+		void releaseDefaultThreads() {
+			claimCount--;
+		}
+	}
+}
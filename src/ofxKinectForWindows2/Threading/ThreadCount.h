@@ -0,0 +1,17 @@
+#pragma once
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// Threads of ThreadPool::getDefault() and of ThreadPools constructed with 0 threads. By default the hardware
+		// threads less one (for the main thread, which joins in parallelFor). Set it before the shared pools are used.
+		void setDefaultThreadCount(int);
+		int getDefaultThreadCount();
+
+		// Threads for an Executor or WorkStealingPool constructed with 0 threads (the shared ones included), whose
+		// workers run alongside the main thread rather than instead of it. Each one claimed while others are alive
+		// gets a share of getDefaultThreadCount(), so an app which only uses one of them still gets every core.
+		// Give them back with releaseDefaultThreads() when the pool is destroyed.
+		int claimDefaultThreads();
+		void releaseDefaultThreads();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "ThreadPool.h"
+#include "../Utils.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		static thread_local bool insideTask = false;
+
+		//----------
+		ThreadPool::ThreadPool(int threadCount) {
+			if (threadCount <= 0) {
+				threadCount = getDefaultThreadCount();
+			}
+
+			this->task = nullptr;
+			this->count = 0;
+			this->next.store(0);
+			this->active = 0;
+			this->generation = 0;
+			this->exiting = false;
+
+			for (int i = 0; i < threadCount; i++) {
+				this->threads.emplace_back(&ThreadPool::workerLoop, this);
+			}
+		}
+
+		//----------
+		ThreadPool::~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->exiting = true;
+			}
+			this->wake.notify_all();
+			for (auto & thread : this->threads) {
+				thread.join();
+			}
+		}
+
+		//----------
+		ThreadPool & ThreadPool::getDefault() {
+			static ThreadPool pool;
+			return pool;
+		}
+
+		//----------
+		int ThreadPool::getThreadCount() const {
+			return (int) this->threads.size();
+		}
+
+		//----------
+		void ThreadPool::parallelFor(int count, const std::function<void(int)> & task) {
+			if (count <= 0) {
+				return;
+			}
+			if (this->threads.empty() || count == 1 || insideTask) {
+				for (int i = 0; i < count; i++) {
+					task(i);
+				}
+				return;
+			}
+
+			std::lock_guard<std::mutex> callLock(this->callMutex);
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->task = &task;
+				this->count = count;
+				this->next.store(0);
+				this->generation++;
+			}
+			this->wake.notify_all();
+
+			this->runTasks(&task, count);
+
+			//wait for workers still running an item, then retire the task so late wakers skip it
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->done.wait(lock, [this] { return this->active == 0; });
+			this->task = nullptr;
+		}
+
+		//----------
+		void ThreadPool::workerLoop() {
+			uint64_t seenGeneration = 0;
+			std::unique_lock<std::mutex> lock(this->mutex);
+			for (;;) {
+				this->wake.wait(lock, [this, &seenGeneration] {
+					return this->exiting || (this->task && this->generation != seenGeneration);
+				});
+				if (this->exiting) {
+					return;
+				}
+
+				seenGeneration = this->generation;
+				auto task = this->task;
+				auto count = this->count;
+				this->active++;
+				lock.unlock();
+
+				this->runTasks(task, count);
+
+				lock.lock();
+				if (--this->active == 0) {
+					this->done.notify_all();
+				}
+			}
+		}
+
+		//----------
+		void ThreadPool::runTasks(const std::function<void(int)> * task, int count) {
+			insideTask = true;
+			int index;
+			while ((index = this->next.fetch_add(1)) < count) {
+				try {
+					(*task)(index);
+				}
+				catch (std::exception & e) {
+					OFXKINECTFORWINDOWS2_ERROR << e.what();
+				}
+				catch (...) {
+					OFXKINECTFORWINDOWS2_ERROR << "Task threw an exception which isn't a std::exception";
+				}
+			}
+			insideTask = false;
+		}
+	}
+}
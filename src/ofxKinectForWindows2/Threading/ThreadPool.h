@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ThreadCount.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// Persistent worker threads for splitting per-frame work (e.g. row bands of an image).
+		// parallelFor() runs on the workers and the calling thread and returns when all items are done.
+		// Calls from inside a task run serially, so nesting can't deadlock.
+		class ThreadPool {
+		public:
+			// 0 threads means getDefaultThreadCount()
+			ThreadPool(int threadCount = 0);
+			~ThreadPool();
+
+			// Shared pool used by the addon's processing components
+			static ThreadPool & getDefault();
+
+			int getThreadCount() const;
+
+			void parallelFor(int count, const std::function<void(int)> & task);
+		protected:
+			void workerLoop();
+			void runTasks(const std::function<void(int)> * task, int count);
+
+			std::vector<std::thread> threads;
+
+			std::mutex callMutex; // one parallelFor at a time
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable done;
+
+			const std::function<void(int)> * task;
+			int count;
+			std::atomic<int> next;
+			int active;
+			uint64_t generation;
+			bool exiting;
+		};
+	}
+}
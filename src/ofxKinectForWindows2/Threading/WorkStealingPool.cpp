@@ -0,0 +1,152 @@
+#include "WorkStealingPool.h"
+#include "../Utils.h"
+#include "ofMain.h"
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// the pool and worker index of the calling thread, if it is a worker
+		static thread_local WorkStealingPool * currentPool = nullptr;
+		static thread_local int currentWorker = -1;
+
+		//----------
+		WorkStealingPool::WorkStealingPool(int threadCount) {
+			this->claimedThreads = threadCount <= 0;
+			if (this->claimedThreads) {
+				threadCount = claimDefaultThreads();
+			}
+
+			this->queued = 0;
+			this->unfinished = 0;
+			this->nextWorker = 0;
+			this->stealCount = 0;
+			this->exiting = false;
+
+			for (int i = 0; i < threadCount; i++) {
+				this->workers.emplace_back(new Worker());
+			}
+			for (int i = 0; i < threadCount; i++) {
+				this->threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+			}
+		}
+
+		//----------
+		WorkStealingPool::~WorkStealingPool() {
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->exiting = true;
+			}
+			this->wake.notify_all();
+			for (auto & thread : this->threads) {
+				thread.join();
+			}
+			if (this->claimedThreads) {
+				releaseDefaultThreads();
+			}
+		}
+
+		//----------
+		WorkStealingPool & WorkStealingPool::getDefault() {
+			static WorkStealingPool pool;
+			return pool;
+		}
+
+		//----------
+		int WorkStealingPool::getThreadCount() const {
+			return (int) this->threads.size();
+		}
+
+		//----------
+		void WorkStealingPool::submit(std::function<void()> task) {
+			const int index = currentPool == this
+				? currentWorker
+				: (int) (this->nextWorker++ % this->workers.size());
+
+			this->unfinished++;
+			{
+				auto & worker = *this->workers[index];
+				std::lock_guard<std::mutex> lock(worker.mutex);
+				worker.tasks.push_back(std::move(task));
+			}
+			{
+				//counted under the lock so a worker checking before it sleeps can't miss it
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->queued++;
+			}
+			this->wake.notify_one();
+		}
+
+		//----------
+		void WorkStealingPool::waitIdle() {
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->idle.wait(lock, [this] { return this->unfinished == 0; });
+		}
+
+		//----------
+		uint64_t WorkStealingPool::getStealCount() const {
+			return this->stealCount;
+		}
+
+		//----------
+		bool WorkStealingPool::take(int index, Task & task) {
+			{
+				auto & worker = *this->workers[index];
+				std::lock_guard<std::mutex> lock(worker.mutex);
+				if (!worker.tasks.empty()) {
+					task = std::move(worker.tasks.back());
+					worker.tasks.pop_back();
+					this->queued--;
+					return true;
+				}
+			}
+
+			const int count = (int) this->workers.size();
+			for (int i = 1; i < count; i++) {
+				auto & victim = *this->workers[(index + i) % count];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty()) {
+					task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					this->queued--;
+					this->stealCount++;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//----------
+		void WorkStealingPool::workerLoop(int index) {
+			currentPool = this;
+			currentWorker = index;
+
+			Task task;
+			for (;;) {
+				if (!this->take(index, task)) {
+					std::unique_lock<std::mutex> lock(this->mutex);
+					this->wake.wait(lock, [this] { return this->exiting || this->queued > 0; });
+					//drain the deques before exiting
+					if (this->exiting && this->queued == 0) {
+						return;
+					}
+					continue;
+				}
+
+				try {
+					task();
+				}
+				catch (std::exception & e) {
+					OFXKINECTFORWINDOWS2_ERROR << e.what();
+				}
+				catch (...) {
+					OFXKINECTFORWINDOWS2_ERROR << "Task threw an exception which isn't a std::exception";
+				}
+				task = nullptr;
+
+				if (--this->unfinished == 0) {
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->idle.notify_all();
+				}
+			}
+		}
+	}
+}
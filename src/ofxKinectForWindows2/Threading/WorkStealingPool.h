@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ThreadCount.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxKinectForWindows2 {
+	namespace Threading {
+		// Worker threads with one task deque each. Tasks submitted from a worker go on its own deque and are taken
+		// newest first (they often use data the worker just produced), idle workers steal the oldest tasks of the
+		// others. Used by Processing::Graph, whose nodes spawn their successors as they finish.
+		class WorkStealingPool {
+		public:
+			// 0 threads means claimDefaultThreads()
+			WorkStealingPool(int threadCount = 0);
+			// Runs the tasks already submitted (and the ones they submit) before the threads exit
+			~WorkStealingPool();
+
+			static WorkStealingPool & getDefault();
+
+			int getThreadCount() const;
+
+			void submit(std::function<void()> task);
+			// Blocks until every submitted task has finished (don't call from a task)
+			void waitIdle();
+
+			// Tasks taken from another worker's deque
+			uint64_t getStealCount() const;
+		protected:
+			typedef std::function<void()> Task;
+			struct Worker {
+				std::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+			void workerLoop(int index);
+			bool take(int index, Task &);
+
+			std::vector<std::unique_ptr<Worker>> workers;
+			std::vector<std::thread> threads;
+
+			std::mutex mutex; // guards sleeping and waking
+			std::condition_variable wake;
+			std::condition_variable idle;
+			std::atomic<int> queued; // in the deques
+			std::atomic<int> unfinished; // queued or running
+			std::atomic<unsigned> nextWorker;
+			std::atomic<uint64_t> stealCount;
+			bool exiting;
+			bool claimedThreads;
+		};
+	}
+}